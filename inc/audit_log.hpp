@@ -0,0 +1,93 @@
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include "structs.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#ifdef _WIN32
+#include <fstream>
+#endif
+
+/// @brief AuditLog class for writing every rolled die to a compact binary file and decoding it again
+class AuditLog {
+public:
+    /// @brief Constructor for AuditLog, creates the log file.
+    /// @param file_name Name of the file to write the log to.
+    explicit AuditLog(const std::string &file_name);
+
+    /// @brief Destructor for AuditLog, writes the remaining buffered rolls and closes the file.
+    ~AuditLog();
+
+    AuditLog(const AuditLog &) = delete;
+    AuditLog &operator=(const AuditLog &) = delete;
+
+    /// @brief Starts a block of rolls, preceded by the definition of the attack set if it changed.
+    /// @param set Index of the attack set in the session.
+    /// @param seed Seed the rolls of the block were made with.
+    /// @param offset Index of the roll (or trial) of the attack set.
+    /// @param vals Values of the attack set.
+    /// @param unit_max Highest value a single die (or keep highest pool) of every damage can roll.
+    void begin_block(uint64_t set, uint64_t seed, uint64_t offset, const RollVals &vals, const std::vector<int> &unit_max);
+
+    /// @brief Appends a rolled value to the current block.
+    /// @param value Rolled value, at least 1.
+    void record(int value) {
+        uint32_t stored = static_cast<uint32_t>(value - 1);
+        for (int i = 0; i < _width; i++) {
+            put(static_cast<uint8_t>(stored >> (8 * i)));
+        }
+    }
+
+    /// @brief Decodes an audit log and prints every attack in it.
+    /// @param file_name Name of the audit log file.
+    static void read(const std::string &file_name);
+
+private:
+    /// @brief Appends a single byte to the log.
+    /// @param byte Byte to append.
+    void put(uint8_t byte) {
+        if (_used == _size) {
+            flush();
+        }
+        _data[_used++] = byte;
+    }
+
+    /// @brief Appends an unsigned integer as a variable length integer (7 bits per byte).
+    /// @param value Value to append.
+    void put_varint(uint64_t value);
+
+    /// @brief Appends a signed integer as a zigzag encoded variable length integer.
+    /// @param value Value to append.
+    void put_signed(int64_t value);
+
+    /// @brief Writes the full buffer to the file and starts a new one.
+    void flush();
+
+    /// @brief Writes the buffered bytes and closes the file.
+    void close();
+
+    /// @brief Start of the buffer the next bytes are written to
+    uint8_t *_data{ nullptr };
+    /// @brief Size of the buffer in bytes
+    size_t _size{};
+    /// @brief Amount of bytes used in the buffer
+    size_t _used{};
+    /// @brief Amount of bytes per rolled value in the current block
+    int _width{ 1 };
+    /// @brief Attack set of the last written set definition
+    uint64_t _last_set{ UINT64_MAX };
+    /// @brief Seed of the last written set definition
+    uint64_t _last_seed{};
+#ifdef _WIN32
+    /// @brief Output file
+    std::ofstream _file{};
+    /// @brief Buffer for the output file
+    std::vector<uint8_t> _buffer{};
+#else
+    /// @brief File descriptor of the output file
+    int _fd{ -1 };
+#endif
+};
+
+#endif // AUDIT_LOG_H
\ No newline at end of file
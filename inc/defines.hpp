@@ -5,5 +5,9 @@
 #define CRIT 20
 #define CRIT_MISS 1
 #define CRIT_MULTIPLIER 2
+#define EXPLODE_LIMIT 5
+#define EXACT_SIZE_LIMIT 20000
+#define OPTIMIZE_SAMPLES 100000
+#define AUDIT_BUFFER (1 << 20)
 
 #endif // DEFINES_H
\ No newline at end of file
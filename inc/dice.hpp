@@ -0,0 +1,43 @@
+#ifndef DICE_H
+#define DICE_H
+
+#include "structs.hpp"
+#include "distribution.hpp"
+#include <string>
+
+/// @brief Parses the dice modifiers following the dice of a damage (format: r2, m2, kh3 and/or !).
+/// @param modifiers String containing the dice modifiers, may be empty.
+/// @param damage Damage to set the dice modifiers of, dice_count and dice_sides must already be set.
+void parse_dice_modifiers(const std::string &modifiers, Damage &damage);
+
+/// @brief Checks if the dice of a damage use any dice modifier.
+/// @param damage Damage to check.
+/// @return True if a dice modifier is used, false for plain dice.
+bool is_modified(const Damage &damage);
+
+/// @brief Amount of separately rolled units of a damage, a keep highest pool counts as one unit.
+/// @param damage Damage to count the units of.
+/// @return Amount of units rolled for the damage.
+int dice_units(const Damage &damage);
+
+/// @brief Calculates the exact distribution of a single unit (one die, or one keep highest pool).
+/// @param damage Damage to calculate the unit distribution of.
+/// @return Distribution of a single unit.
+Distribution unit_distribution(const Damage &damage);
+
+/// @brief Calculates the exact distribution of all dice of a damage, without the flat modifier.
+/// @param damage Damage to calculate the dice distribution of.
+/// @return Distribution of all dice of the damage.
+Distribution dice_distribution(const Damage &damage);
+
+/// @brief Builds the alias table for drawing a unit of a damage with a single random number.
+/// @param damage Damage to build the table for.
+/// @return DieTable struct, empty for plain dice.
+DieTable die_table(const Damage &damage);
+
+/// @brief Formats the dice of a damage in the damage format, e.g. 4d6kh3.
+/// @param damage Damage to format.
+/// @return Dice notation of the damage.
+std::string dice_notation(const Damage &damage);
+
+#endif // DICE_H
\ No newline at end of file
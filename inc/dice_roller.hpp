@@ -2,39 +2,129 @@
 #define DICE_ROLLER_H
 
 #include "structs.hpp"
+#include "audit_log.hpp"
+#include "philox.hpp"
 #include <vector>
 #include <string>
 #include <regex>
+#include <random>
+#include <limits>
+#include <cstdint>
 
 /// @brief DiceRoller class for rolling dice based on provided Options class or file input
 class DiceRoller {
 public:
-    /// @brief Constructor for DiceRoller, initializes random seed.
+    /// @brief Constructor for DiceRoller, initializes a random seed.
     DiceRoller();
 
-    /// @brief Rolls the dice based on the values in the file.
-    /// @param file_name name of the file to read values from.
-    void roll(const std::string &file_name);
+    /// @brief Rolls all attack sets of a loaded attack file.
+    /// @param file Attack file loaded with load() and completed with resolve().
+    void roll(const AttackFile &file);
 
     /// @brief Rolls the dice based on the values set in the class.
     void roll() const;
 
+    /// @brief Rolls the dice based on the values set in the class without printing anything.
+    /// @return Outcome counts and total damage per damage type of the rolled attacks.
+    RollTotals roll_totals() const;
+
+    /// @brief Draws the totals of all attacks at once instead of resolving them attack by attack.
+    /// The outcome counts and the damage totals have the same distribution as roll_totals().
+    /// @return Outcome counts and total damage per damage type of the rolled attacks.
+    RollTotals roll_aggregate() const;
+
+    /// @brief Sets whether roll() only prints the totals, using roll_aggregate() instead of rolling every attack.
+    /// @param totals_only True to only print the totals.
+    void set_totals_only(bool totals_only) { _totals_only = totals_only; }
+
+    /// @brief Reads all attack sets from the file, missing values are left unset.
+    /// @param file_name name of the file to read values from.
+    /// @return AttackFile struct with the attack sets in the file, in file order.
+    AttackFile load(const std::string &file_name);
+
+    /// @brief Fills in the missing attack types and ACs of all attack sets before anything is rolled.
+    /// Missing values are taken from the defaults first, the remaining ones are asked once for all attack sets.
+    /// Throws if the input ends before a missing value was entered, so batch jobs without input fail instead of waiting.
+    /// @param files Attack files to complete.
+    /// @param defaults Values to use for missing values, UNSET attack type and AC 0 are ignored.
+    void resolve(std::vector<AttackFile> &files, const RollVals &defaults);
+
+    /// @brief Reseeds the random number generator.
+    /// @param seed Seed to use for the following rolls.
+    void seed(uint64_t seed) {
+        _seed = seed;
+        _engine.seed(seed);
+    }
+
+    /// @brief Accessor for the seed of the random number generator.
+    /// @return Seed of the random number generator.
+    uint64_t seed() const { return _seed; }
+
+    /// @brief Sets the position of the following rolls in the session. The dice of a roll only depend on
+    /// the seed and this position, so any roll can be skipped to or recomputed in O(1).
+    /// @param set Index of the attack set in the session.
+    /// @param offset Index of the roll (or trial) of the attack set.
+    void set_position(uint64_t set, uint64_t offset) {
+        _set = set;
+        _offset = offset;
+    }
+
+    /// @brief Sets the audit log every rolled die is written to.
+    /// @param audit Audit log to write to, nullptr to disable logging.
+    void set_audit(AuditLog *audit) { _audit = audit; }
+
     /// @brief Sets the values for the current roll.
     /// @param vals Values to set for the current roll.
-    void set_vals(const RollVals &vals) { _vals = vals; }
+    void set_vals(const RollVals &vals);
 
 private:
     /// @brief Sets the attack type based on user input.
-    void set_attack_type();
+    /// @return False if the input ended before a valid attack type was entered.
+    bool set_attack_type();
 
     /// @brief Sets the armor class (AC) based on user input.
-    void set_ac();
+    /// @return False if the input ended before a valid AC was entered.
+    bool set_ac();
+
+    /// @brief Precomputes the alias tables of the modified dice in _vals.
+    void build_tables();
 
-    /// @brief Rolls the damage based on the number of dice and sides of the dice.
-    /// @param dice_count Number of dice to roll.
-    /// @param dice_sides Sides of the dice to roll.
+    /// @brief Rolls the damage based on the dice of a damage in _vals.
+    /// @param index Index of the damage in _vals.damages.
+    /// @param units Number of dice (or keep highest pools) to roll.
     /// @return Total number(damage) rolled.
-    int damage(int dice_count, int dice_sides) const;
+    int64_t damage(size_t index, int64_t units) const;
+
+    /// @brief Draws the sum of a large amount of dice by drawing how often each outcome is rolled.
+    /// @param index Index of the damage in _vals.damages.
+    /// @param units Number of dice (or keep highest pools) to roll.
+    /// @return Total number(damage) rolled.
+    int64_t damage_sum(size_t index, int64_t units) const;
+
+    /// @brief Draws a uniform random number between 0 and 1, both excluded.
+    /// @return Random number.
+    double uniform() const;
+
+    /// @brief Draws the amount of successes of independent tries with the same chance. Uses a fixed algorithm
+    /// instead of std::binomial_distribution, so the draw is the same with every standard library.
+    /// @param count Amount of tries.
+    /// @param chance Chance of success of a single try.
+    /// @return Amount of successes.
+    int64_t binomial(int64_t count, double chance) const;
+
+    /// @brief Draws the outcome of a modified die from its alias table with a single random number.
+    /// @param table Alias table of the modified die.
+    /// @return Outcome of the modified die.
+    int sample(const DieTable &table) const;
+
+    /// @brief Rolls the d20 for a single attack based on the attack type.
+    /// @return Value of the d20 that counts for the attack.
+    int attack_roll() const;
+
+    /// @brief Checks if an attack roll hits based on the AC and critical hit/miss conditions.
+    /// @param roll Value of the d20 that counts for the attack.
+    /// @return True if the attack hits, false otherwise.
+    bool hits(int roll) const;
 
     /// @brief Generates a random number between 1 and the number of sides on the dice.
     /// @param dice_sides Number of sides on the dice.
@@ -50,10 +140,43 @@ private:
     bool check_values() const;
 
     /// @brief Regex for parsing damage strings
-    std::regex _damage_regex{ R"((\d+)d(\d+)(?:\s*([+-]\s*\d+))?\s*([a-zA-Z]+))" };
+    std::regex _damage_regex{ R"((\d+)d(\d+)((?:\s*(?:r\d+|m\d+|kh\d+|!))*)(?:\s*([+-]\s*\d+))?\s*([a-zA-Z]+))" };
 
     /// @brief Values for the current roll
     RollVals _vals{};
+
+    /// @brief Alias tables of the damages in _vals, empty tables for plain dice
+    std::vector<DieTable> _tables{};
+
+    /// @brief Highest value of a single die (or keep highest pool) of the damages in _vals
+    std::vector<int> _unit_max{};
+
+    /// @brief Chance of every side of the plain dice in _vals, used by damage_sum(), empty for modified dice
+    std::vector<std::vector<double>> _plain_odds{};
+
+    /// @brief Seed of the random number generator
+    uint64_t _seed{};
+
+    /// @brief Index of the current attack set in the session
+    uint64_t _set{};
+
+    /// @brief Index of the current roll of the attack set
+    uint64_t _offset{};
+
+    /// @brief Audit log every rolled die is written to, nullptr if disabled
+    AuditLog *_audit{ nullptr };
+
+    /// @brief Counter based random number generator used for all dice
+    mutable Philox _engine{};
+
+    /// @brief Attack index used for the draws of roll_aggregate()
+    static constexpr uint32_t AGGREGATE_ATTACK = std::numeric_limits<uint32_t>::max();
+
+    /// @brief Expected successes below which binomial() adds up waiting times instead of using rejection
+    static constexpr double BINOMIAL_INVERSION = 10.0;
+
+    /// @brief Flag to indicate if roll() only prints the totals
+    bool _totals_only{};
 };
 
 #endif // DICE_ROLLER_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+#include <vector>
+
+/// @brief Distribution class holding the exact chance of every integer value of a random total
+class Distribution {
+public:
+    /// @brief Constructor for Distribution, always 0.
+    Distribution() = default;
+
+    /// @brief Creates the distribution of the sum of a number of dice.
+    /// @param dice_count Number of dice to roll.
+    /// @param dice_sides Sides of the dice to roll.
+    /// @return Distribution of the sum of the dice.
+    static Distribution dice(int dice_count, int dice_sides);
+
+    /// @brief Creates a distribution from the chances of consecutive values.
+    /// @param offset Lowest value of the distribution.
+    /// @param odds Chance of every value, starting at offset.
+    /// @return Distribution with the given chances.
+    static Distribution from_odds(int offset, const std::vector<double> &odds);
+
+    /// @brief Creates the distribution that picks one of several distributions.
+    /// @param parts Pairs of the chance of picking a distribution and the distribution itself.
+    /// @return Mixed distribution.
+    static Distribution mixture(const std::vector<std::pair<double, Distribution>> &parts);
+
+    /// @brief Calculates the distribution of the sum of this and another independent distribution.
+    /// @param other Distribution to add.
+    /// @return Distribution of the sum.
+    Distribution operator+(const Distribution &other) const;
+
+    /// @brief Calculates the distribution of this distribution with a constant added.
+    /// @param offset Constant to add to every value.
+    /// @return Shifted distribution.
+    Distribution shifted(int offset) const;
+
+    /// @brief Calculates the distribution of this distribution multiplied by a constant.
+    /// @param factor Constant to multiply every value with, must be at least 1.
+    /// @return Scaled distribution.
+    Distribution scaled(int factor) const;
+
+    /// @brief Calculates the distribution of the sum of count independent copies of this distribution.
+    /// @param count Number of copies, must be at least 0.
+    /// @return Distribution of the sum.
+    Distribution repeated(int count) const;
+
+    /// @brief Chance of a value being at least the given value.
+    /// @param value Value to compare against.
+    /// @return Chance of the total being at least value.
+    double at_least(int value) const;
+
+    /// @brief Calculates the mean of the distribution.
+    /// @return Mean of the distribution.
+    double mean() const;
+
+    /// @brief Calculates the variance of the distribution.
+    /// @return Variance of the distribution.
+    double variance() const;
+
+    /// @brief Accessor for the chances of all values.
+    /// @return Vector with the chance of every value, starting at min().
+    const std::vector<double> &odds() const { return _odds; }
+
+    /// @brief Accessor for the lowest possible value.
+    /// @return Lowest value of the distribution.
+    int min() const { return _offset; }
+
+    /// @brief Accessor for the highest possible value.
+    /// @return Highest value of the distribution.
+    int max() const { return _offset + static_cast<int>(_odds.size()) - 1; }
+
+private:
+    /// @brief Lowest value of the distribution
+    int _offset{};
+
+    /// @brief Chance of every value, starting at _offset
+    std::vector<double> _odds{ 1.0 };
+};
+
+#endif // DISTRIBUTION_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "structs.hpp"
+#include "dice_roller.hpp"
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/// @brief Optimizer class for ranking alternative attack sets against a distribution of target ACs
+class Optimizer {
+public:
+    /// @brief Constructor for Optimizer.
+    /// @param targets Pairs of target AC and weight, empty to use the AC of each candidate.
+    /// @param hp Hit points of the target to rank by kill chance, 0 to rank by expected damage.
+    /// @param seed Seed of the sampled evaluations, the same seed gives the same ranking.
+    Optimizer(const std::vector<std::pair<int, double>> &targets, int hp, uint64_t seed);
+
+    /// @brief Bounds, prunes and evaluates all candidates.
+    /// @param candidates Attack sets to rank.
+    void run(const std::vector<RollVals> &candidates);
+
+    /// @brief Prints the ranking of the candidates.
+    void report() const;
+
+private:
+    /// @brief Creates a copy of the candidate for every target AC.
+    /// @param vals Candidate attack set.
+    /// @return Pairs of weight and the candidate against that target.
+    std::vector<std::pair<double, RollVals>> against_targets(const RollVals &vals) const;
+
+    /// @brief Calculates cheap analytic lower and upper bounds of the score of a candidate.
+    /// @param vals Candidate attack set.
+    /// @return Pair of the lower and upper bound.
+    std::pair<double, double> bounds(const RollVals &vals) const;
+
+    /// @brief Calculates the score of a candidate, exactly if feasible and sampled otherwise.
+    /// @param vals Candidate attack set.
+    /// @param sampled Set to true if any target had to be sampled.
+    /// @return Score of the candidate.
+    double evaluate(const RollVals &vals, bool &sampled);
+
+    /// @brief Pairs of target AC and normalized weight
+    std::vector<std::pair<int, double>> _targets{};
+
+    /// @brief Hit points of the target, 0 to rank by expected damage
+    int _hp{};
+
+    /// @brief Evaluations of the candidates
+    std::vector<CandidateResult> _results{};
+
+    /// @brief Roller used for sampled evaluations
+    DiceRoller _roller{};
+};
+
+#endif // OPTIMIZER_H
\ No newline at end of file
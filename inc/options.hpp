@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <regex>
+#include <optional>
+#include <cstdint>
+#include <utility>
 #include "structs.hpp"
 
 /// @brief Options class to handle command line arguments and user input for D&D attack calculations.
@@ -29,6 +32,58 @@ public:
     /// @return Vector of option files.
     const std::vector<std::string> &opts_files() const { return _opts_files; }
 
+    /// @brief Accessor for the totals only flag.
+    /// @return Totals only flag value.
+    bool totals_only() const { return _totals_only; }
+
+    /// @brief Accessor for the optimize flag.
+    /// @return Optimize flag value.
+    bool optimize() const { return _optimize; }
+
+    /// @brief Accessor for the sensitivity flag.
+    /// @return Sensitivity flag value.
+    bool sensitivity() const { return _sensitivity; }
+
+    /// @brief Accessor for the target AC distribution.
+    /// @return Vector of pairs of target AC and weight.
+    const std::vector<std::pair<int, double>> &ac_dist() const { return _ac_dist; }
+
+    /// @brief Accessor for the target hit points.
+    /// @return Hit points of the target, 0 if not passed.
+    int hp() const { return _hp; }
+
+    /// @brief Accessor for the amount of simulation trials.
+    /// @return Amount of trials, 0 if no simulation was requested.
+    uint64_t trials() const { return _trials; }
+
+    /// @brief Accessor for the simulation seed.
+    /// @return Seed if one was passed, std::nullopt otherwise.
+    const std::optional<uint64_t> &seed() const { return _seed; }
+
+    /// @brief Accessor for the shard index of the simulation.
+    /// @return Zero based index of the shard to run.
+    int shard_index() const { return _shard_index; }
+
+    /// @brief Accessor for the amount of shards the simulation is split into.
+    /// @return Amount of shards.
+    int shard_count() const { return _shard_count; }
+
+    /// @brief Accessor for the partial result file.
+    /// @return Name of the file to write partial results to, empty if the report should be printed.
+    const std::string &partial_file() const { return _partial_file; }
+
+    /// @brief Accessor for the partial result files to merge.
+    /// @return Vector of partial result files.
+    const std::vector<std::string> &merge_files() const { return _merge_files; }
+
+    /// @brief Accessor for the audit log file.
+    /// @return Name of the file to write the audit log to, empty if disabled.
+    const std::string &audit_file() const { return _audit_file; }
+
+    /// @brief Accessor for the audit log file to decode.
+    /// @return Name of the audit log file to decode, empty if none.
+    const std::string &read_audit_file() const { return _read_audit_file; }
+
     /// @brief Accessor for the help flag.
     /// @return Help flag value.
     bool help() const { return _help; }
@@ -67,8 +122,38 @@ private:
 
     /// @brief Flag to indicate if only files should be processed
     bool _only_files{};
+
+    /// @brief Flag to indicate if only the total damage should be rolled and printed
+    bool _totals_only{};
+
+    /// @brief Flag to indicate if the attack sets should be ranked instead of rolled
+    bool _optimize{};
+    /// @brief Flag to indicate if a sensitivity report should be printed instead of rolling
+    bool _sensitivity{};
+    /// @brief Target ACs and their weights for the optimizer
+    std::vector<std::pair<int, double>> _ac_dist{};
+    /// @brief Hit points of the target for the optimizer, 0 to rank by expected damage
+    int _hp{};
+
+    /// @brief Amount of simulation trials per attack set, 0 for a normal roll
+    uint64_t _trials{};
+    /// @brief Seed for the simulation
+    std::optional<uint64_t> _seed{};
+    /// @brief Zero based index of the shard to run
+    int _shard_index{};
+    /// @brief Amount of shards the simulation is split into
+    int _shard_count{ 1 };
+    /// @brief File to write the partial simulation results to
+    std::string _partial_file{};
+    /// @brief Partial result files to merge
+    std::vector<std::string> _merge_files{};
+
+    /// @brief File to write the audit log to
+    std::string _audit_file{};
+    /// @brief Audit log file to decode
+    std::string _read_audit_file{};
     /// @brief Regex for parsing damage strings
-    std::regex _damage_regex{ R"((\d+)d(\d+)(?:\s*([+-]\s*\d+))?\s*([a-zA-Z]+))" };
+    std::regex _damage_regex{ R"((\d+)d(\d+)((?:\s*(?:r\d+|m\d+|kh\d+|!))*)(?:\s*([+-]\s*\d+))?\s*([a-zA-Z]+))" };
 };
 
 #endif // OPTIONS_H
\ No newline at end of file
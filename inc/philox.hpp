@@ -0,0 +1,75 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/// @brief Philox4x32-10 counter based random number generator.
+/// Every die has its own key and counter made from its position (attack set, roll, attack and die index),
+/// so the value of any die only depends on the seed and its position.
+class Philox {
+public:
+    using result_type = uint64_t;
+
+    /// @brief Constructor for Philox.
+    /// @param seed Seed used as the key of the generator.
+    explicit Philox(uint64_t seed = 0) { this->seed(seed); }
+
+    /// @brief Sets the key of the generator and moves to the first die of the first attack.
+    /// @param seed Seed used as the key of the generator.
+    void seed(uint64_t seed);
+
+    /// @brief Moves to the first die of an attack, in O(1).
+    /// @param set Index of the attack set in the session.
+    /// @param offset Index of the roll (or trial) of the attack set.
+    /// @param attack Index of the attack in the roll.
+    void seek(uint64_t set, uint64_t offset, uint32_t attack);
+
+    /// @brief Moves to the next die of the current attack.
+    void next_die() {
+        _counter[0] = ++_die << DIE_SHIFT;
+        _used = WORDS;
+    }
+
+    /// @brief Generates the next random number of the current die.
+    /// @return Random 64 bit number.
+    result_type operator()() {
+        // A die normally needs a single number, extra numbers (rejection sampling) come from following blocks
+        if (_used == WORDS) {
+            generate();
+        }
+        result_type value = (static_cast<uint64_t>(_block[2 * _used]) << 32) | _block[2 * _used + 1];
+        _used++;
+        return value;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+    /// @brief Amount of 64 bit numbers in a block
+    static constexpr int WORDS = 2;
+    /// @brief Amount of bits of the first counter word used for the blocks of a single die
+    static constexpr int DIE_SHIFT = 8;
+    /// @brief Step of the key per attack set, odd so different sets of a seed never share a key
+    static constexpr uint64_t SET_STEP = 0x9E3779B97F4A7C15ull;
+
+    /// @brief Encrypts the current counter into _block and moves the counter to the next block.
+    void generate();
+
+    /// @brief Seed of the generator
+    uint64_t _seed{};
+    /// @brief Key of the current attack set, derived from the seed
+    std::array<uint32_t, 2> _key{};
+    /// @brief Counter of the next block: die and block index, attack and the low and high word of the roll
+    std::array<uint32_t, 4> _counter{};
+    /// @brief Last generated block
+    std::array<uint32_t, 4> _block{};
+    /// @brief Index of the current die in the attack
+    uint32_t _die{};
+    /// @brief Amount of 64 bit numbers of _block that were used
+    int _used{ WORDS };
+};
+
+#endif // PHILOX_H
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef PROBABILITY_H
+#define PROBABILITY_H
+
+#include "structs.hpp"
+#include "distribution.hpp"
+#include <array>
+
+/// @brief Calculates the chance of each d20 value being the one that counts for an attack.
+/// @param attack_type Attack type of the attack, UNSET is treated as NORMAL.
+/// @return Array with the chance of each value, indexed by the d20 value (index 0 is unused).
+std::array<double, D20 + 1> d20_odds(AttackType attack_type);
+
+/// @brief Calculates the chances of a single attack missing, hitting and critically hitting.
+/// @param vals Values of the attack set, uses ac, modifier, attack type and crit range.
+/// @return OutcomeOdds struct with the chance of each outcome.
+OutcomeOdds outcome_odds(const RollVals &vals);
+
+/// @brief Calculates the moments and range of the dice of a single damage for one hit.
+/// @param damage Damage to calculate the moments of.
+/// @return HitMoments struct of the dice and flat modifier of the damage.
+HitMoments hit_moments(const Damage &damage);
+
+/// @brief Calculates the moments and range of the dice of all damages for one hit.
+/// @param vals Values of the attack set.
+/// @return HitMoments struct of the dice and flat modifiers of all damages.
+HitMoments hit_moments(const RollVals &vals);
+
+/// @brief Combines the outcome chances and the damage of a hit into the moments of the total damage.
+/// @param odds Chances of the outcomes of a single attack.
+/// @param hit Moments of the damage of a single hit.
+/// @param attack_count Number of attacks.
+/// @return DamageMoments struct of the total damage of all attacks.
+DamageMoments combine_moments(const OutcomeOdds &odds, const HitMoments &hit, int attack_count);
+
+/// @brief Calculates the mean, variance and range of the total damage of all attacks in the attack set.
+/// @param vals Values of the attack set.
+/// @return DamageMoments struct of the total damage over all damage types.
+DamageMoments damage_moments(const RollVals &vals);
+
+/// @brief Checks that the total damage of an attack set can be counted in 64 bits, also for huge attack counts.
+/// Throws if it can't.
+/// @param vals Attack set to check.
+void check_damage_range(const RollVals &vals);
+
+/// @brief Calculates the exact distribution of the total damage of a single attack.
+/// @param vals Values of the attack set.
+/// @return Distribution of the damage over all damage types of one attack.
+Distribution attack_distribution(const RollVals &vals);
+
+/// @brief Calculates the exact distribution of the total damage of all attacks in the attack set.
+/// @param vals Values of the attack set.
+/// @return Distribution of the damage over all damage types of all attacks.
+Distribution damage_distribution(const RollVals &vals);
+
+#endif // PROBABILITY_H
\ No newline at end of file
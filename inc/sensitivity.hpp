@@ -0,0 +1,32 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "structs.hpp"
+#include <vector>
+#include <string>
+
+/// @brief Sensitivity class for calculating how the damage of attack sets changes when one of their values is improved
+class Sensitivity {
+public:
+    /// @brief Calculates the effect of every change for all attack sets.
+    /// @param sets Attack sets to analyze.
+    void run(const std::vector<RollVals> &sets);
+
+    /// @brief Prints the effect of every change for all attack sets.
+    void report() const;
+
+    /// @brief Calculates the exact mean and variance of the total damage of an attack set and of its improved neighbors.
+    /// All neighbors are derived from a single base evaluation of the d20 and dice distributions.
+    /// @param vals Attack set to analyze.
+    /// @return Vector with the base attack set first, followed by one entry per change.
+    static std::vector<SensitivityResult> analyze(const RollVals &vals);
+
+private:
+    /// @brief Descriptions of the analyzed attack sets
+    std::vector<std::string> _descriptions{};
+
+    /// @brief Results of the analyzed attack sets
+    std::vector<std::vector<SensitivityResult>> _results{};
+};
+
+#endif // SENSITIVITY_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "structs.hpp"
+#include "dice_roller.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/// @brief Simulator class for running seeded, shardable simulations of attack sets and merging their results
+class Simulator {
+public:
+    /// @brief Constructor for an empty Simulator, used to merge partial result files into.
+    Simulator() = default;
+
+    /// @brief Constructor for Simulator.
+    /// @param seed Seed of the simulation, every trial is derived from it.
+    /// @param trials Total amount of trials per attack set over all shards.
+    /// @param shard_index Zero based index of the shard this Simulator runs.
+    /// @param shard_count Amount of shards the trials are split into.
+    Simulator(uint64_t seed, uint64_t trials, int shard_index = 0, int shard_count = 1);
+
+    /// @brief Runs the trials of this shard for all attack sets.
+    /// @param sets Attack sets to simulate.
+    void run(const std::vector<RollVals> &sets);
+
+    /// @brief Sets whether the trials draw their totals at once instead of rolling every attack.
+    /// @param totals_only True to draw the totals at once.
+    void set_totals_only(bool totals_only) { _result.totals_only = totals_only; }
+
+    /// @brief Sets the audit log every rolled die of the trials is written to.
+    /// @param audit Audit log to write to, nullptr to disable logging.
+    void set_audit(AuditLog *audit) { _roller.set_audit(audit); }
+
+    /// @brief Merges a partial result file into the current results.
+    /// @param file_name Name of the partial result file.
+    void merge(const std::string &file_name);
+
+    /// @brief Writes the current results to a partial result file.
+    /// @param file_name Name of the file to write to.
+    void save(const std::string &file_name) const;
+
+    /// @brief Prints the report of the current results.
+    void report() const;
+
+    /// @brief Accessor for the current results.
+    /// @return SimResult struct containing the current results.
+    const SimResult &result() const { return _result; }
+
+    /// @brief Creates a one line description of an attack set, used to check merged sets match and in reports.
+    /// @param vals Attack set to describe.
+    /// @param with_ac False to leave out the AC, for attack sets that are evaluated against other ACs.
+    /// @return Description of the attack set.
+    static std::string describe(const RollVals &vals, bool with_ac = true);
+
+private:
+    /// @brief Reads a partial result file.
+    /// @param file_name Name of the partial result file.
+    /// @return SimResult struct containing the results in the file.
+    static SimResult read(const std::string &file_name);
+
+    /// @brief Results of the simulation so far
+    SimResult _result{};
+
+    /// @brief Roller used to roll the trials
+    DiceRoller _roller{};
+};
+
+#endif // SIMULATOR_H
\ No newline at end of file
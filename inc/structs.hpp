@@ -3,6 +3,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <cstdint>
 #include "enums.hpp"
 #include "defines.hpp"
 
@@ -12,6 +14,18 @@ struct Damage {
     int dice_count;
     int dice_sides;
     int modifier;
+    int reroll{};
+    int minimum{};
+    int keep{};
+    bool explode{};
+};
+
+/// @brief Struct to hold the precomputed alias table of a modified die
+struct DieTable {
+    int offset{};
+    std::vector<uint64_t> threshold;
+    std::vector<uint32_t> alias;
+    std::vector<double> odds;
 };
 
 /// @brief Struct to hold the values for the current roll
@@ -25,4 +39,85 @@ struct RollVals {
     bool empty{ true };
 };
 
+/// @brief Struct to hold the attack sets read from an attack file
+struct AttackFile {
+    std::string name;
+    std::vector<RollVals> sets;
+};
+
+/// @brief Struct to hold the outcome counts and damage totals of a set of rolled attacks
+struct RollTotals {
+    int64_t hits{};
+    int64_t crits{};
+    int64_t misses{};
+    std::map<std::string, int64_t> damage;
+};
+
+/// @brief Struct to hold the chances of the outcomes of a single attack
+struct OutcomeOdds {
+    double miss{};
+    double hit{};
+    double crit{};
+};
+
+/// @brief Struct to hold the moments and range of the damage of a single (non critical) hit
+struct HitMoments {
+    double mean{};
+    double variance{};
+    int64_t min{};
+    int64_t max{};
+    int modifier{};
+};
+
+/// @brief Struct to hold the effect of changing one value of an attack set
+struct SensitivityResult {
+    std::string change;
+    double mean{};
+    double variance{};
+};
+
+/// @brief Struct to hold the moments and range of the total damage of an attack set
+struct DamageMoments {
+    double mean{};
+    double variance{};
+    int64_t min{};
+    int64_t max{};
+};
+
+/// @brief Struct to hold the evaluation of a single optimizer candidate
+struct CandidateResult {
+    std::string description;
+    double lower{};
+    double upper{};
+    double value{};
+    bool pruned{};
+    bool sampled{};
+};
+
+/// @brief Struct to hold the simulated damage of one damage type over all trials
+struct DamageStats {
+    int64_t sum{};
+    std::map<int64_t, uint64_t> histogram;
+};
+
+/// @brief Struct to hold the simulation results of a single attack set
+struct SetResult {
+    std::string description;
+    uint64_t hits{};
+    uint64_t crits{};
+    uint64_t misses{};
+    std::map<std::string, DamageStats> damage;
+};
+
+/// @brief Struct to hold the (partial) results of a simulation run
+struct SimResult {
+    uint64_t seed{};
+    uint64_t trials{};
+    bool totals_only{};
+    int shard_count{};
+    std::vector<int> shards;
+    uint64_t runs{};
+    std::vector<SetResult> sets;
+};
+
 #endif // STRUCTS_H
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include <iostream>
 #include <string>
+#include <memory>
 #include "options.hpp"
 #include "dice_roller.hpp"
+#include "simulator.hpp"
+#include "optimizer.hpp"
+#include "sensitivity.hpp"
+#include "probability.hpp"
 
 int main(int argc, char **argv) {
     Options options{};
@@ -27,7 +32,127 @@ int main(int argc, char **argv) {
         options.set_manual();
     }
 
+    // If partial result files are passed, merge them and print or save the combined results
+    if (!options.merge_files().empty()) {
+        try {
+            Simulator simulator{};
+            for (const std::string &file : options.merge_files()) {
+                simulator.merge(file);
+            }
+            if (options.partial_file().empty()) {
+                simulator.report();
+            }
+            else {
+                simulator.save(options.partial_file());
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // If an audit log is passed, decode it and print its attacks
+    if (!options.read_audit_file().empty()) {
+        try {
+            AuditLog::read(options.read_audit_file());
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     DiceRoller roller{};
+    roller.set_totals_only(options.totals_only());
+    std::unique_ptr<AuditLog> audit{};
+    if (!options.audit_file().empty()) {
+        try {
+            audit = std::make_unique<AuditLog>(options.audit_file());
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        roller.set_audit(audit.get());
+    }
+    // Read all attack files and fill in their missing values before anything is rolled, so rolling never waits for input
+    std::vector<AttackFile> files{};
+    std::vector<RollVals> sets{};
+    try {
+        for (const std::string &file : options.opts_files()) {
+            files.push_back(roller.load(file));
+        }
+        roller.resolve(files, options.vals());
+        if (!options.only_files()) {
+            sets.push_back(options.vals());
+        }
+        for (const AttackFile &file : files) {
+            sets.insert(sets.end(), file.sets.begin(), file.sets.end());
+        }
+        // Totals are counted in 64 bits, attack sets that could deal more damage are rejected before anything is rolled
+        for (const RollVals &vals : sets) {
+            check_damage_range(vals);
+        }
+    }
+    catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // If a sensitivity report is requested, print it instead of rolling
+    if (options.sensitivity()) {
+        Sensitivity sensitivity{};
+        sensitivity.run(sets);
+        sensitivity.report();
+        return EXIT_SUCCESS;
+    }
+
+    // If optimizing, rank all attack sets against the targets instead of rolling them
+    if (options.optimize()) {
+        try {
+            uint64_t seed = options.seed() ? *options.seed() : roller.seed();
+            Optimizer optimizer{ options.ac_dist(), options.hp(), seed };
+            optimizer.run(sets);
+            optimizer.report();
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // If a simulation is requested, simulate all attack sets instead of rolling them once
+    if (options.trials() != 0) {
+        try {
+            uint64_t seed = options.seed() ? *options.seed() : roller.seed();
+            Simulator simulator{ seed, options.trials(), options.shard_index(), options.shard_count() };
+            simulator.set_totals_only(options.totals_only());
+            simulator.set_audit(audit.get());
+            simulator.run(sets);
+            if (options.partial_file().empty()) {
+                simulator.report();
+            }
+            else {
+                simulator.save(options.partial_file());
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // The seed is printed so the session can be replayed
+    if (options.seed()) {
+        roller.seed(*options.seed());
+    }
+    std::cout << "Seed: " << roller.seed() << std::endl;
+
     // If only_files is false, roll the attack(s) based on the options provided
     if (!options.only_files()) {
         roller.set_vals(options.vals());
@@ -36,12 +161,12 @@ int main(int argc, char **argv) {
         std::cout << std::endl;
     }
     // If there are files specified, roll attack(s) with the values in those files
-    if (!options.opts_files().empty()) {
+    if (!files.empty()) {
         // For each file specified in the options, roll the attack(s) defined in the file
-        for (size_t i = 0; i < options.opts_files().size(); i++) {
-            std::cout << "Rolling dice of file: " << options.opts_files().at(i) << "..." << std::endl;
+        for (size_t i = 0; i < files.size(); i++) {
+            std::cout << "Rolling dice of file: " << files.at(i).name << "..." << std::endl;
             std::cout << std::endl;
-            roller.roll(options.opts_files().at(i));
+            roller.roll(files.at(i));
         }
     }
     return EXIT_SUCCESS;
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include "audit_log.hpp"
+#include "dice.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/// @brief Magic bytes at the start of every audit log, followed by the format version
+static const char AUDIT_MAGIC[] = { 'D', 'N', 'D', 'A', 1 };
+
+AuditLog::AuditLog(const std::string &file_name) {
+    _size = AUDIT_BUFFER;
+#ifdef _WIN32
+    _file.open(file_name, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open()) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    _buffer.resize(_size);
+    _data = _buffer.data();
+#else
+    _fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    // The buffer is anonymous mapped memory that is reused for every write, so it never reallocates
+    void *buffer = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        ::close(_fd);
+        throw std::runtime_error("Could not map audit log buffer");
+    }
+    _data = static_cast<uint8_t *>(buffer);
+#endif
+    for (char byte : AUDIT_MAGIC) {
+        put(static_cast<uint8_t>(byte));
+    }
+}
+
+AuditLog::~AuditLog() {
+    close();
+}
+
+void AuditLog::begin_block(uint64_t set, uint64_t seed, uint64_t offset, const RollVals &vals, const std::vector<int> &unit_max) {
+    // The attack set is only described again when it or its seed changes
+    if (set != _last_set || seed != _last_seed) {
+        int highest = std::max(D20, unit_max.empty() ? 0 : *std::max_element(unit_max.begin(), unit_max.end()));
+        int width = highest <= (1 << 8) ? 1 : (highest <= (1 << 16) ? 2 : 4);
+        put('S');
+        put_varint(set);
+        put_varint(seed);
+        put_signed(vals.ac);
+        put_signed(vals.modifier);
+        put_signed(vals.attack_type);
+        put_signed(vals.crit_range);
+        put_varint(static_cast<uint64_t>(vals.attack_count));
+        put(static_cast<uint8_t>(width));
+        put_varint(vals.damages.size());
+        for (const Damage &damage : vals.damages) {
+            put_varint(static_cast<uint64_t>(damage.dice_count));
+            put_varint(static_cast<uint64_t>(damage.dice_sides));
+            put_signed(damage.modifier);
+            put_varint(static_cast<uint64_t>(damage.reroll));
+            put_varint(static_cast<uint64_t>(damage.minimum));
+            put_varint(static_cast<uint64_t>(damage.keep));
+            put(damage.explode ? 1 : 0);
+            put_varint(damage.type.size());
+            for (char c : damage.type) {
+                put(static_cast<uint8_t>(c));
+            }
+        }
+        _width = width;
+        _last_set = set;
+        _last_seed = seed;
+    }
+    put('B');
+    put_varint(set);
+    put_varint(offset);
+}
+
+void AuditLog::put_varint(uint64_t value) {
+    while (value >= 0x80) {
+        put(static_cast<uint8_t>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    put(static_cast<uint8_t>(value));
+}
+
+void AuditLog::put_signed(int64_t value) {
+    put_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void AuditLog::flush() {
+#ifdef _WIN32
+    _file.write(reinterpret_cast<const char *>(_data), static_cast<std::streamsize>(_used));
+    if (!_file.good()) {
+        throw std::runtime_error("Could not write audit log");
+    }
+#else
+    size_t written{};
+    while (written < _used) {
+        ssize_t result = ::write(_fd, _data + written, _used - written);
+        if (result < 0) {
+            throw std::runtime_error("Could not write audit log");
+        }
+        written += static_cast<size_t>(result);
+    }
+#endif
+    _used = 0;
+}
+
+void AuditLog::close() {
+#ifdef _WIN32
+    if (_file.is_open()) {
+        _file.write(reinterpret_cast<const char *>(_data), static_cast<std::streamsize>(_used));
+        _file.close();
+    }
+#else
+    if (_fd >= 0) {
+        try {
+            flush();
+        }
+        catch (const std::runtime_error &e) {
+            std::cerr << e.what() << std::endl;
+        }
+        munmap(_data, _size);
+        ::close(_fd);
+        _fd = -1;
+    }
+#endif
+}
+
+/// @brief Reader for the bytes of an audit log.
+class AuditReader {
+public:
+    /// @brief Constructor for AuditReader.
+    /// @param bytes Bytes of the audit log.
+    explicit AuditReader(const std::vector<uint8_t> &bytes) : _bytes{ bytes } {}
+
+    /// @brief Checks if all bytes have been read.
+    /// @return True if there are no bytes left.
+    bool done() const { return _pos >= _bytes.size(); }
+
+    /// @brief Reads a single byte.
+    /// @return Byte that was read.
+    uint8_t byte() {
+        if (done()) {
+            throw std::invalid_argument("Audit log ends in the middle of a block.");
+        }
+        return _bytes[_pos++];
+    }
+
+    /// @brief Reads a variable length integer.
+    /// @return Value that was read.
+    uint64_t varint() {
+        uint64_t value{};
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t current = byte();
+            value |= static_cast<uint64_t>(current & 0x7f) << shift;
+            if ((current & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::invalid_argument("Invalid integer in audit log.");
+    }
+
+    /// @brief Reads a zigzag encoded variable length integer.
+    /// @return Value that was read.
+    int64_t signed_varint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /// @brief Reads a rolled value.
+    /// @param width Amount of bytes per rolled value.
+    /// @return Rolled value.
+    int value(int width) {
+        uint32_t stored{};
+        for (int i = 0; i < width; i++) {
+            stored |= static_cast<uint32_t>(byte()) << (8 * i);
+        }
+        return static_cast<int>(stored) + 1;
+    }
+
+private:
+    /// @brief Bytes of the audit log
+    const std::vector<uint8_t> &_bytes;
+    /// @brief Position of the next byte to read
+    size_t _pos{};
+};
+
+void AuditLog::read(const std::string &file_name) {
+    std::ifstream file{ file_name, std::ios::binary };
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    if (bytes.size() < sizeof(AUDIT_MAGIC) || std::memcmp(bytes.data(), AUDIT_MAGIC, sizeof(AUDIT_MAGIC)) != 0) {
+        throw std::invalid_argument("File is not an audit log: " + file_name);
+    }
+    AuditReader reader{ bytes };
+    for (size_t i = 0; i < sizeof(AUDIT_MAGIC); i++) {
+        reader.byte();
+    }
+    // Definitions of the attack sets seen so far, with the seed and value width they were logged with
+    struct SetDefinition {
+        RollVals vals;
+        uint64_t seed;
+        int width;
+    };
+    std::map<uint64_t, SetDefinition> sets{};
+    while (!reader.done()) {
+        uint8_t tag = reader.byte();
+        if (tag == 'S') {
+            uint64_t set = reader.varint();
+            SetDefinition definition{};
+            definition.seed = reader.varint();
+            definition.vals.ac = static_cast<int>(reader.signed_varint());
+            definition.vals.modifier = static_cast<int>(reader.signed_varint());
+            definition.vals.attack_type = static_cast<AttackType>(reader.signed_varint());
+            definition.vals.crit_range = static_cast<int>(reader.signed_varint());
+            definition.vals.attack_count = static_cast<int>(reader.varint());
+            definition.width = reader.byte();
+            uint64_t damage_count = reader.varint();
+            for (uint64_t i = 0; i < damage_count; i++) {
+                Damage damage{};
+                damage.dice_count = static_cast<int>(reader.varint());
+                damage.dice_sides = static_cast<int>(reader.varint());
+                damage.modifier = static_cast<int>(reader.signed_varint());
+                damage.reroll = static_cast<int>(reader.varint());
+                damage.minimum = static_cast<int>(reader.varint());
+                damage.keep = static_cast<int>(reader.varint());
+                damage.explode = reader.byte() != 0;
+                uint64_t length = reader.varint();
+                for (uint64_t j = 0; j < length; j++) {
+                    damage.type += static_cast<char>(reader.byte());
+                }
+                definition.vals.damages.push_back(damage);
+            }
+            sets[set] = definition;
+            continue;
+        }
+        if (tag != 'B') {
+            throw std::invalid_argument("Invalid block in audit log: " + file_name);
+        }
+        uint64_t set = reader.varint();
+        uint64_t offset = reader.varint();
+        if (!sets.contains(set)) {
+            throw std::invalid_argument("Block of undefined attack set in audit log: " + file_name);
+        }
+        const SetDefinition &definition = sets.at(set);
+        const RollVals &vals = definition.vals;
+        std::cout << "Attack set " << set << ", roll " << offset << ", seed " << definition.seed << ": "
+                  << vals.attack_count << " attacks with AC: " << vals.ac << std::endl;
+        std::map<std::string, int> total{};
+        for (int i = 0; i < vals.attack_count; i++) {
+            // Same attack roll, hit and crit conditions as DiceRoller::roll()
+            int roll = reader.value(definition.width);
+            std::string d20 = std::to_string(roll);
+            if (vals.attack_type == ADVANTAGE || vals.attack_type == DISADVANTAGE) {
+                int second = reader.value(definition.width);
+                d20 += "/" + std::to_string(second);
+                roll = vals.attack_type == ADVANTAGE ? std::max(roll, second) : std::min(roll, second);
+            }
+            std::cout << "Attack " << i + 1 << " (d20: " << d20 << "): ";
+            if (!(((roll + vals.modifier) >= vals.ac || roll == CRIT) && roll != CRIT_MISS)) {
+                std::cout << "Missed" << (roll == CRIT_MISS ? " (Critical Miss)" : "") << std::endl;
+                continue;
+            }
+            int multiplier = roll >= vals.crit_range ? CRIT_MULTIPLIER : 1;
+            for (size_t j = 0; j < vals.damages.size(); j++) {
+                const Damage &damage = vals.damages.at(j);
+                std::string dice{};
+                int sum{};
+                for (int unit = 0; unit < dice_units(damage); unit++) {
+                    int value = reader.value(definition.width);
+                    dice += (unit == 0 ? "" : ", ") + std::to_string(value);
+                    sum += value;
+                }
+                int attack_damage = sum * multiplier + damage.modifier;
+                total[damage.type] += attack_damage;
+                std::cout << attack_damage << " " << damage.type << " [" << dice_notation(damage) << ": " << dice << "]";
+                if (j < vals.damages.size() - 1) {
+                    std::cout << " + ";
+                }
+            }
+            std::cout << " Damage" << (multiplier == CRIT_MULTIPLIER ? " (Critical Hit)" : "") << std::endl;
+        }
+        std::cout << "Total Damage:" << std::endl;
+        for (const auto &[key, value] : total) {
+            std::cout << value << " " << key << " Damage" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+}
\ No newline at end of file
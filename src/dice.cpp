@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <regex>
+#include <stdexcept>
+#include "dice.hpp"
+
+void parse_dice_modifiers(const std::string &modifiers, Damage &damage) {
+    std::regex modifier_regex{ R"(\s*(?:(r|m|kh)(\d+)|(!)))" };
+    auto begin = std::sregex_iterator(modifiers.begin(), modifiers.end(), modifier_regex);
+    auto end = std::sregex_iterator();
+    for (auto i = begin; i != end; i++) {
+        std::smatch match = *i;
+        if (match[3].matched) {
+            if (damage.dice_sides < 2) {
+                throw std::invalid_argument("Only dice with at least 2 sides can explode: " + modifiers);
+            }
+            damage.explode = true;
+            continue;
+        }
+        int value = std::stoi(match[2].str());
+        if (match[1].str() == "r") {
+            // Rerolling every value would never end, so the highest side can't be rerolled
+            if (value < 1 || value >= damage.dice_sides) {
+                throw std::invalid_argument("Invalid reroll value: " + match.str());
+            }
+            damage.reroll = value;
+        }
+        else if (match[1].str() == "m") {
+            if (value < 1 || value > damage.dice_sides) {
+                throw std::invalid_argument("Invalid minimum value: " + match.str());
+            }
+            damage.minimum = value;
+        }
+        else {
+            if (value < 1 || value > damage.dice_count) {
+                throw std::invalid_argument("Invalid keep highest value: " + match.str());
+            }
+            damage.keep = value;
+        }
+    }
+}
+
+bool is_modified(const Damage &damage) {
+    return damage.reroll != 0 || damage.minimum != 0 || damage.keep != 0 || damage.explode;
+}
+
+int dice_units(const Damage &damage) {
+    return damage.keep != 0 ? 1 : damage.dice_count;
+}
+
+/// @brief Calculates the distribution of a single die with the reroll, minimum and explode modifiers.
+/// @param damage Damage to calculate the die distribution of.
+/// @return Distribution of a single die.
+static Distribution single_die(const Damage &damage) {
+    int sides = damage.dice_sides;
+    double chance = 1.0 / sides;
+    // Values up to the reroll value are rerolled once and the second roll is kept
+    std::vector<double> odds(static_cast<size_t>(sides), 0.0);
+    for (int value = 1; value <= sides; value++) {
+        odds[static_cast<size_t>(value - 1)] = (value <= damage.reroll ? 0.0 : chance) + damage.reroll * chance * chance;
+    }
+    // Values below the minimum count as the minimum
+    for (int value = 1; value < damage.minimum; value++) {
+        odds[static_cast<size_t>(damage.minimum - 1)] += odds[static_cast<size_t>(value - 1)];
+        odds[static_cast<size_t>(value - 1)] = 0.0;
+    }
+    Distribution die = Distribution::from_odds(1, odds);
+    if (!damage.explode) {
+        return die;
+    }
+    // Every roll of the highest side adds another plain die, up to EXPLODE_LIMIT extra dice
+    Distribution plain = Distribution::from_odds(1, std::vector<double>(static_cast<size_t>(sides - 1), chance));
+    Distribution extra{};
+    for (int i = 0; i < EXPLODE_LIMIT; i++) {
+        extra = Distribution::mixture({ { 1.0, plain }, { chance, extra.shifted(sides) } });
+    }
+    // The odds without the highest side are already scaled by their chance, so they are mixed in as is
+    double max_chance = odds.back();
+    odds.back() = 0.0;
+    return Distribution::mixture({ { 1.0, Distribution::from_odds(1, odds) }, { max_chance, extra.shifted(sides) } });
+}
+
+Distribution unit_distribution(const Damage &damage) {
+    Distribution die = single_die(damage);
+    if (damage.keep == 0) {
+        return die;
+    }
+    // Keep highest pool: go through the die values from high to low, tracking how many dice have a
+    // value at least as high (assigned) and the sum of the kept dice among them
+    int count = damage.dice_count;
+    size_t sums = static_cast<size_t>(damage.keep * die.max() + 1);
+    std::vector<std::vector<double>> pool(static_cast<size_t>(count + 1), std::vector<double>(sums, 0.0));
+    pool[0][0] = 1.0;
+    for (int value = die.max(); value >= die.min(); value--) {
+        double chance = die.odds()[static_cast<size_t>(value - die.min())];
+        if (chance == 0.0) {
+            continue;
+        }
+        std::vector<std::vector<double>> next(static_cast<size_t>(count + 1), std::vector<double>(sums, 0.0));
+        for (int assigned = 0; assigned <= count; assigned++) {
+            for (size_t sum = 0; sum < sums; sum++) {
+                double current = pool[static_cast<size_t>(assigned)][sum];
+                if (current == 0.0) {
+                    continue;
+                }
+                // Chance of exactly showing times this value among the unassigned dice, binomial coefficient included
+                double ways = current;
+                for (int showing = 0; assigned + showing <= count; showing++) {
+                    int kept = std::min(showing, std::max(damage.keep - assigned, 0));
+                    next[static_cast<size_t>(assigned + showing)][sum + static_cast<size_t>(kept * value)] += ways;
+                    ways *= chance * (count - assigned - showing) / (showing + 1);
+                }
+            }
+        }
+        pool = next;
+    }
+    // The lowest kept sum is keep times the lowest value, so everything below it is trimmed
+    int low = damage.keep * die.min();
+    std::vector<double> odds(pool[static_cast<size_t>(count)].begin() + low, pool[static_cast<size_t>(count)].end());
+    return Distribution::from_odds(low, odds);
+}
+
+Distribution dice_distribution(const Damage &damage) {
+    return unit_distribution(damage).repeated(dice_units(damage));
+}
+
+DieTable die_table(const Damage &damage) {
+    DieTable table{};
+    if (!is_modified(damage)) {
+        return table;
+    }
+    Distribution unit = unit_distribution(damage);
+    table.offset = unit.min();
+    table.odds = unit.odds();
+    // Vose's alias method: every slot keeps its own value with chance threshold / 2^32 and its alias otherwise
+    size_t size = table.odds.size();
+    table.threshold.assign(size, uint64_t{ 1 } << 32);
+    table.alias.resize(size);
+    std::vector<double> scaled(size);
+    std::vector<size_t> small{};
+    std::vector<size_t> large{};
+    for (size_t i = 0; i < size; i++) {
+        table.alias[i] = static_cast<uint32_t>(i);
+        scaled[i] = table.odds[i] * static_cast<double>(size);
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        size_t less = small.back();
+        small.pop_back();
+        size_t more = large.back();
+        large.pop_back();
+        table.threshold[less] = static_cast<uint64_t>(scaled[less] * 4294967296.0);
+        table.alias[less] = static_cast<uint32_t>(more);
+        scaled[more] += scaled[less] - 1.0;
+        (scaled[more] < 1.0 ? small : large).push_back(more);
+    }
+    return table;
+}
+
+std::string dice_notation(const Damage &damage) {
+    std::string notation = std::to_string(damage.dice_count) + "d" + std::to_string(damage.dice_sides);
+    if (damage.reroll != 0) {
+        notation += "r" + std::to_string(damage.reroll);
+    }
+    if (damage.minimum != 0) {
+        notation += "m" + std::to_string(damage.minimum);
+    }
+    if (damage.keep != 0) {
+        notation += "kh" + std::to_string(damage.keep);
+    }
+    if (damage.explode) {
+        notation += "!";
+    }
+    return notation;
+}
\ No newline at end of file
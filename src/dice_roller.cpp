@@ -1,34 +1,43 @@
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
-#include <ctime>
+#include <stdexcept>
 #include <iostream>
 #include <map>
 #include <vector>
 #include <fstream>
 #include "dice_roller.hpp"
+#include "probability.hpp"
+#include "dice.hpp"
 
 DiceRoller::DiceRoller() {
-    std::srand(static_cast<unsigned int>(time(0)));
+    // Two 32 bit values from the random device, so runs started at the same time get different seeds
+    std::random_device device{};
+    seed((static_cast<uint64_t>(device()) << 32) | device());
 }
 
 void DiceRoller::roll() const {
-    std::map<std::string, int> total{};
+    std::map<std::string, int64_t> total{};
     // Start rolling attacks based on the values set in _vals
     std::cout << "Rolling " << _vals.attack_count << " attacks with AC: " << _vals.ac << std::endl;
-    for (int i = 0; i < _vals.attack_count; i++) {
-        // Roll attack roll based on the attack type
-        int roll = 0;
-        if (_vals.attack_type == NORMAL) {
-            roll = rand(D20);
-        }
-        else if (_vals.attack_type == ADVANTAGE) {
-            roll = std::max(rand(D20), rand(D20));
-        }
-        else if (_vals.attack_type == DISADVANTAGE) {
-            roll = std::min(rand(D20), rand(D20));
+    if (_audit != nullptr && !_totals_only) {
+        _audit->begin_block(_set, _seed, _offset, _vals, _unit_max);
+    }
+    // If only the totals are needed, draw them all at once instead of rolling every attack
+    if (_totals_only) {
+        RollTotals totals = roll_aggregate();
+        std::cout << "Hits: " << totals.hits << ", Critical Hits: " << totals.crits << ", Misses: " << totals.misses << std::endl;
+        std::cout << "Total Damage:" << std::endl;
+        for (const auto &[key, value] : totals.damage) {
+            std::cout << value << " " << key << " Damage" << std::endl;
         }
+        return;
+    }
+    for (int i = 0; i < _vals.attack_count; i++) {
+        _engine.seek(_set, _offset, static_cast<uint32_t>(i));
+        int roll = attack_roll();
         std::cout << "Attack " << i + 1 << ": ";
-        // Check if the roll hits or misses based on the AC and critical hit/miss conditions
-        if (((roll + _vals.modifier) >= _vals.ac || roll == CRIT) && roll != CRIT_MISS) {
+        if (hits(roll)) {
             int multiplier{ 1 };
             // Set the multiplier to 2 if the roll is a critical hit
             if (roll >= _vals.crit_range) {
@@ -37,7 +46,7 @@ void DiceRoller::roll() const {
             // Calculate the total damage for each damage type
             for (size_t j = 0; j < _vals.damages.size(); j++) {
                 Damage current_damage = _vals.damages.at(j);
-                int attack_damage = (damage(current_damage.dice_count, current_damage.dice_sides) * multiplier) + current_damage.modifier;
+                int64_t attack_damage = (damage(j, dice_units(current_damage)) * multiplier) + current_damage.modifier;
 
                 if (total.contains(current_damage.type)) {
                     total[current_damage.type] += attack_damage;
@@ -73,69 +82,166 @@ void DiceRoller::roll() const {
     }
 }
 
-void DiceRoller::roll(const std::string &file_name) {
-    // Initialize variables
+RollTotals DiceRoller::roll_totals() const {
+    RollTotals totals{};
+    if (_audit != nullptr) {
+        _audit->begin_block(_set, _seed, _offset, _vals, _unit_max);
+    }
+    for (int i = 0; i < _vals.attack_count; i++) {
+        _engine.seek(_set, _offset, static_cast<uint32_t>(i));
+        int roll = attack_roll();
+        if (!hits(roll)) {
+            totals.misses++;
+            continue;
+        }
+        int multiplier{ 1 };
+        if (roll >= _vals.crit_range) {
+            multiplier = CRIT_MULTIPLIER;
+            totals.crits++;
+        }
+        else {
+            totals.hits++;
+        }
+        for (size_t j = 0; j < _vals.damages.size(); j++) {
+            const Damage &current_damage = _vals.damages.at(j);
+            totals.damage[current_damage.type] += (damage(j, dice_units(current_damage)) * multiplier) + current_damage.modifier;
+        }
+    }
+    return totals;
+}
+
+RollTotals DiceRoller::roll_aggregate() const {
+    RollTotals totals{};
+    OutcomeOdds odds = outcome_odds(_vals);
+    // All draws of the aggregate roll get their own attack index, every draw counts as one die
+    _engine.seek(_set, _offset, AGGREGATE_ATTACK);
+    // Draw the outcome counts of all attacks from one multinomial sample, as a binomial for the crits
+    // followed by a binomial for the hits among the remaining attacks
+    totals.crits = binomial(_vals.attack_count, odds.crit);
+    _engine.next_die();
+    int64_t remaining = _vals.attack_count - totals.crits;
+    double hit_chance = odds.crit < 1.0 ? std::min(odds.hit / (1.0 - odds.crit), 1.0) : 0.0;
+    totals.hits = binomial(remaining, hit_chance);
+    _engine.next_die();
+    totals.misses = remaining - totals.hits;
+    // Crits double the rolled dice instead of rolling more dice, so the dice of hits and crits are drawn separately
+    for (size_t j = 0; j < _vals.damages.size(); j++) {
+        const Damage &current_damage = _vals.damages.at(j);
+        // Dice counts and totals are 64 bit, check_damage_range() makes sure they can't overflow
+        int64_t hit_damage = damage_sum(j, totals.hits * dice_units(current_damage));
+        int64_t crit_damage = damage_sum(j, totals.crits * dice_units(current_damage));
+        totals.damage[current_damage.type] += hit_damage + (crit_damage * CRIT_MULTIPLIER) + (totals.hits + totals.crits) * current_damage.modifier;
+    }
+    return totals;
+}
+
+void DiceRoller::roll(const AttackFile &file) {
+    for (size_t i = 0; i < file.sets.size(); i++) {
+        std::cout << "Rolling attack set: " << i + 1 << " from file: " << file.name << std::endl;
+        // Roll the attack with the values set
+        set_position(_set + 1, 0);
+        set_vals(file.sets.at(i));
+        roll();
+        std::cout << std::endl;
+    }
+}
+
+AttackFile DiceRoller::load(const std::string &file_name) {
+    AttackFile attack_file{};
+    attack_file.name = file_name;
     _vals = RollVals{};
     std::ifstream file{ file_name };
-    int attack_num{ 1 };
-    // Check if the file is open and keep reading until the end of the file
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    // Keep reading until the end of the file, every empty line ends an attack set
     while (file.good()) {
-        if (_vals.empty) {
-            std::cout << "Rolling attack set: " << attack_num << " from file: " << file_name << std::endl;
-            _vals.empty = false;
-        }
         std::string buf{};
         std::getline(file, buf);
-        // If the line is empty, check if we have valid values to roll
-        if (buf.empty()) {
-            if (check_values()) {
-                // If the attack type is UNSET, ask the user for input
-                if (_vals.attack_type == UNSET) {
-                    set_attack_type();
-                }
-                // If the AC is not set, ask the user for input
-                if (_vals.ac == 0) {
-                    set_ac();
-                }
-                // Roll the attack with the values set
-                roll();
-                attack_num++;
-            }
-            else {
-                std::cerr << "Invalid values in file: " << file_name << " at attack set: " << attack_num << std::endl;
-                exit(EXIT_FAILURE);
-            }
-            _vals = RollVals{};
-            std::cout << std::endl;
+        if (!buf.empty()) {
+            get_values(buf);
+            _vals.empty = false;
             continue;
         }
-        try {
-            get_values(buf);
+        if (_vals.empty) {
+            continue;
         }
-        catch (const std::invalid_argument &e) {
-            std::cerr << e.what() << std::endl;
-            exit(EXIT_FAILURE);
+        if (!check_values()) {
+            throw std::invalid_argument("Invalid values in file: " + file_name + " at attack set: " + std::to_string(attack_file.sets.size() + 1));
         }
+        attack_file.sets.push_back(_vals);
+        _vals = RollVals{};
+    }
+    return attack_file;
+}
 
+void DiceRoller::resolve(std::vector<AttackFile> &files, const RollVals &defaults) {
+    // Collect the attack sets that are still missing values after applying the defaults
+    std::vector<RollVals *> missing_type{};
+    std::vector<RollVals *> missing_ac{};
+    std::string missing_type_names{};
+    std::string missing_ac_names{};
+    for (AttackFile &file : files) {
+        for (size_t i = 0; i < file.sets.size(); i++) {
+            RollVals &vals = file.sets.at(i);
+            std::string name = "attack set " + std::to_string(i + 1) + " of " + file.name;
+            if (vals.attack_type == UNSET) {
+                vals.attack_type = defaults.attack_type;
+            }
+            if (vals.attack_type == UNSET) {
+                missing_type.push_back(&vals);
+                missing_type_names += (missing_type_names.empty() ? "" : ", ") + name;
+            }
+            if (vals.ac == 0) {
+                vals.ac = defaults.ac;
+            }
+            if (vals.ac == 0) {
+                missing_ac.push_back(&vals);
+                missing_ac_names += (missing_ac_names.empty() ? "" : ", ") + name;
+            }
+        }
+    }
+    // Ask every missing value once for all attack sets missing it
+    if (!missing_type.empty()) {
+        std::cout << "No attack type given for " << missing_type_names << "." << std::endl;
+        if (!set_attack_type()) {
+            throw std::invalid_argument("No attack type given for " + missing_type_names + " and no input left to ask it, pass --attack-type.");
+        }
+        for (RollVals *vals : missing_type) {
+            vals->attack_type = _vals.attack_type;
+        }
+    }
+    if (!missing_ac.empty()) {
+        std::cout << "No AC given for " << missing_ac_names << "." << std::endl;
+        if (!set_ac()) {
+            throw std::invalid_argument("No AC given for " + missing_ac_names + " and no input left to ask it, pass --ac.");
+        }
+        for (RollVals *vals : missing_ac) {
+            vals->ac = _vals.ac;
+        }
     }
 }
 
-void DiceRoller::set_attack_type() {
+bool DiceRoller::set_attack_type() {
     std::cout << "Are the attacks (A)dvantage or (D)isadvantage, leave empty for standard: ";
     while (true) {
         std::string input;
-        std::getline(std::cin, input);
+        // Closed or exhausted input can never give a valid value
+        if (!std::getline(std::cin, input)) {
+            std::cout << std::endl;
+            return false;
+        }
         if (input.empty()) {
             _vals.attack_type = NORMAL;
-            break;
+            return true;
         }
         else if (input == "A" || input == "a") {
             _vals.attack_type = ADVANTAGE;
-            break;
+            return true;
         }
         else if (input == "D" || input == "d") {
             _vals.attack_type = DISADVANTAGE;
-            break;
+            return true;
         }
         else {
             std::cout << "Invalid input. Please enter A, D, or leave empty for normal: ";
@@ -143,36 +249,215 @@ void DiceRoller::set_attack_type() {
     }
 }
 
-void DiceRoller::set_ac() {
+bool DiceRoller::set_ac() {
     std::cout << "What is the AC of the target: ";
     while (true) {
         std::string input;
-        std::getline(std::cin, input);
+        // Closed or exhausted input can never give a valid value
+        if (!std::getline(std::cin, input)) {
+            std::cout << std::endl;
+            return false;
+        }
         try {
-            _vals.ac = std::stoi(input);
-            break;
-            if (_vals.ac < 1) {
+            int ac = std::stoi(input);
+            if (ac < 1) {
                 throw std::invalid_argument(input);
             }
+            _vals.ac = ac;
+            return true;
         }
-        catch (const std::invalid_argument &) {
+        catch (const std::logic_error &) {
             std::cout << "Invalid input. Please enter a AC: ";
         }
     }
 }
 
-int DiceRoller::damage(int dice_count, int dice_sides) const {
+void DiceRoller::set_vals(const RollVals &vals) {
+    _vals = vals;
+    build_tables();
+}
+
+void DiceRoller::build_tables() {
+    // Modified dice are precomputed once per attack set, so rolling them costs the same as a plain die
+    _tables.clear();
+    _unit_max.clear();
+    _plain_odds.clear();
+    for (const Damage &current_damage : _vals.damages) {
+        _tables.push_back(die_table(current_damage));
+        const DieTable &table = _tables.back();
+        _unit_max.push_back(table.odds.empty() ? current_damage.dice_sides : table.offset + static_cast<int>(table.odds.size()) - 1);
+        // Plain dice have every side as outcome with the same chance, dice with too many sides are always rolled one by one
+        bool plain = table.odds.empty() && current_damage.dice_sides <= EXACT_SIZE_LIMIT;
+        _plain_odds.push_back(plain ? std::vector<double>(static_cast<size_t>(current_damage.dice_sides), 1.0 / current_damage.dice_sides) : std::vector<double>{});
+    }
+}
+
+int64_t DiceRoller::damage(size_t index, int64_t units) const {
     // Rolls the damage based on the number of dice and sides of the dice
-    int sum{};
-    for (int i = 0; i < dice_count; i++) {
-        sum += rand(dice_sides);
+    int64_t sum{};
+    const DieTable &table = _tables.at(index);
+    if (table.odds.empty()) {
+        int dice_sides = _vals.damages.at(index).dice_sides;
+        for (int64_t i = 0; i < units; i++) {
+            sum += rand(dice_sides);
+        }
+    }
+    else {
+        for (int64_t i = 0; i < units; i++) {
+            sum += sample(table);
+        }
     }
     return sum;
 }
 
+int64_t DiceRoller::damage_sum(size_t index, int64_t units) const {
+    const DieTable &table = _tables.at(index);
+    const std::vector<double> &odds = table.odds.empty() ? _plain_odds.at(index) : table.odds;
+    int offset = table.odds.empty() ? 1 : table.offset;
+    // Rolling the dice one by one is cheaper as long as there aren't more dice than outcomes
+    if (units <= static_cast<int64_t>(odds.size()) || odds.empty()) {
+        return damage(index, units);
+    }
+    // Draw how many dice show each outcome, every binomial is conditioned on the dice left for the remaining outcomes
+    int64_t sum{};
+    int64_t remaining = units;
+    double remaining_chance = 1.0;
+    for (size_t i = 0; i + 1 < odds.size() && remaining > 0; i++) {
+        double chance = remaining_chance > 0.0 ? std::clamp(odds[i] / remaining_chance, 0.0, 1.0) : 1.0;
+        int64_t count = binomial(remaining, chance);
+        _engine.next_die();
+        sum += (offset + static_cast<int64_t>(i)) * count;
+        remaining -= count;
+        remaining_chance -= odds[i];
+    }
+    return sum + (offset + static_cast<int64_t>(odds.size()) - 1) * remaining;
+}
+
+double DiceRoller::uniform() const {
+    // The highest 53 bits fill the mantissa, the half step keeps the value away from 0 and 1
+    return (static_cast<double>(_engine() >> 11) + 0.5) * 0x1.0p-53;
+}
+
+/// @brief Error of Stirling's approximation of log(k!), exact for small k and from its series otherwise.
+/// @param k Value to calculate the error for.
+/// @return Error of the approximation.
+static double stirling_tail(double k) {
+    static const double TAIL[] = { 0.0810614667953272, 0.0413406959554092, 0.0276779256849983, 0.02079067210376509, 0.0166446911898211,
+                                   0.0138761288230707, 0.0118967099458917, 0.0104112652619720, 0.00925546218271273, 0.00833056343336287 };
+    if (k <= 9.0) {
+        return TAIL[static_cast<int>(k)];
+    }
+    double square = (k + 1.0) * (k + 1.0);
+    return (1.0 / 12.0 - (1.0 / 360.0 - 1.0 / 1260.0 / square) / square) / (k + 1.0);
+}
+
+int64_t DiceRoller::binomial(int64_t count, double chance) const {
+    if (count <= 0 || chance <= 0.0) {
+        return 0;
+    }
+    if (chance >= 1.0) {
+        return count;
+    }
+    // Both methods below need a chance of at most one half, otherwise the failures are drawn instead
+    if (chance > 0.5) {
+        return count - binomial(count, 1.0 - chance);
+    }
+    double n = static_cast<double>(count);
+    double p = chance;
+    double q = 1.0 - p;
+    // Few expected successes: add up geometric waiting times until they pass the amount of trials
+    if (n * p < BINOMIAL_INVERSION) {
+        double log_q = std::log1p(-p);
+        int64_t successes{};
+        double trials{};
+        while (true) {
+            trials += std::ceil(std::log(uniform()) / log_q);
+            if (trials > n) {
+                return successes;
+            }
+            successes++;
+        }
+    }
+    // Otherwise Hormann's transformed rejection with squeeze (BTRS), which takes about one try regardless of count
+    double spq = std::sqrt(n * p * q);
+    double b = 1.15 + 2.53 * spq;
+    double a = -0.0873 + 0.0248 * b + 0.01 * p;
+    double c = n * p + 0.5;
+    double v_r = 0.92 - 4.2 / b;
+    double r = p / q;
+    double alpha = (2.83 + 5.1 / b) * spq;
+    double m = std::floor((n + 1.0) * p);
+    while (true) {
+        double u = uniform() - 0.5;
+        double v = uniform();
+        double us = 0.5 - std::fabs(u);
+        double k = std::floor((2.0 * a / us + b) * u + c);
+        if (k < 0.0 || k > n) {
+            continue;
+        }
+        if (us >= 0.07 && v <= v_r) {
+            return static_cast<int64_t>(k);
+        }
+        v = std::log(v * alpha / (a / (us * us) + b));
+        double bound = (m + 0.5) * std::log((m + 1.0) / (r * (n - m + 1.0))) + (n + 1.0) * std::log((n - m + 1.0) / (n - k + 1.0))
+            + (k + 0.5) * std::log(r * (n - k + 1.0) / (k + 1.0)) + stirling_tail(m) + stirling_tail(n - m) - stirling_tail(k) - stirling_tail(n - k);
+        if (v <= bound) {
+            return static_cast<int64_t>(k);
+        }
+    }
+}
+
+int DiceRoller::sample(const DieTable &table) const {
+    // The high half of the random number picks a slot, the low half decides between the slot and its alias
+    uint64_t random = _engine();
+    _engine.next_die();
+    size_t slot = static_cast<size_t>(((random >> 32) * table.odds.size()) >> 32);
+    uint64_t low = random & 0xffffffffULL;
+    int value = table.offset + static_cast<int>(low < table.threshold[slot] ? slot : table.alias[slot]);
+    if (_audit != nullptr) {
+        _audit->record(value);
+    }
+    return value;
+}
+
+int DiceRoller::attack_roll() const {
+    // Roll attack roll based on the attack type
+    int roll = 0;
+    if (_vals.attack_type == NORMAL) {
+        roll = rand(D20);
+    }
+    else if (_vals.attack_type == ADVANTAGE) {
+        roll = std::max(rand(D20), rand(D20));
+    }
+    else if (_vals.attack_type == DISADVANTAGE) {
+        roll = std::min(rand(D20), rand(D20));
+    }
+    return roll;
+}
+
+bool DiceRoller::hits(int roll) const {
+    // Check if the roll hits or misses based on the AC and critical hit/miss conditions
+    return ((roll + _vals.modifier) >= _vals.ac || roll == CRIT) && roll != CRIT_MISS;
+}
+
 int DiceRoller::rand(int dice_sides) const {
-    // Generates a random number between 1 and the number of sides on the dice
-    return (std::rand() % dice_sides) + 1;
+    // Generates a random number between 1 and the number of sides on the dice. The high half of the random number
+    // is multiplied by the sides, the few products that would make some sides more likely are drawn again.
+    // Unlike the <random> distributions this gives the same die with every standard library
+    uint64_t sides = static_cast<uint64_t>(dice_sides);
+    uint64_t product = (_engine() >> 32) * sides;
+    if ((product & 0xffffffffULL) < sides) {
+        uint64_t threshold = ((1ULL << 32) - sides) % sides;
+        while ((product & 0xffffffffULL) < threshold) {
+            product = (_engine() >> 32) * sides;
+        }
+    }
+    int value = static_cast<int>(product >> 32) + 1;
+    _engine.next_die();
+    if (_audit != nullptr) {
+        _audit->record(value);
+    }
+    return value;
 }
 
 void DiceRoller::get_values(const std::string &buf) {
@@ -252,13 +537,14 @@ void DiceRoller::get_values(const std::string &buf) {
             std::smatch match = *i;
             damage.dice_count = std::stoi(match[1].str());
             damage.dice_sides = std::stoi(match[2].str());
-            std::string temp = match[3].matched ? match[3].str() : "0";
+            parse_dice_modifiers(match[3].str(), damage);
+            std::string temp = match[4].matched ? match[4].str() : "0";
             size_t idx = temp.find_first_of(" \t\r\n");
             if (idx != std::string::npos) {
                 temp.erase(temp.find_first_of(" \t\r\n"), 1);
             }
             damage.modifier = std::stoi(temp);
-            damage.type = match[4].str();
+            damage.type = match[5].str();
             _vals.damages.push_back(damage);
         }
     }
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "distribution.hpp"
+
+Distribution Distribution::dice(int dice_count, int dice_sides) {
+    Distribution die{};
+    die._offset = 1;
+    die._odds.assign(static_cast<size_t>(dice_sides), 1.0 / dice_sides);
+    return die.repeated(dice_count);
+}
+
+Distribution Distribution::from_odds(int offset, const std::vector<double> &odds) {
+    Distribution result{};
+    result._offset = offset;
+    result._odds = odds;
+    return result;
+}
+
+Distribution Distribution::mixture(const std::vector<std::pair<double, Distribution>> &parts) {
+    Distribution result{};
+    int low{};
+    int high{};
+    bool first{ true };
+    // Find the range covered by all parts with a chance of being picked
+    for (const auto &[chance, part] : parts) {
+        if (chance <= 0.0) {
+            continue;
+        }
+        low = first ? part.min() : std::min(low, part.min());
+        high = first ? part.max() : std::max(high, part.max());
+        first = false;
+    }
+    result._offset = low;
+    result._odds.assign(static_cast<size_t>(high - low + 1), 0.0);
+    for (const auto &[chance, part] : parts) {
+        if (chance <= 0.0) {
+            continue;
+        }
+        for (size_t i = 0; i < part._odds.size(); i++) {
+            result._odds[static_cast<size_t>(part._offset - low) + i] += chance * part._odds[i];
+        }
+    }
+    return result;
+}
+
+Distribution Distribution::operator+(const Distribution &other) const {
+    Distribution result{};
+    result._offset = _offset + other._offset;
+    result._odds.assign(_odds.size() + other._odds.size() - 1, 0.0);
+    for (size_t i = 0; i < _odds.size(); i++) {
+        if (_odds[i] == 0.0) {
+            continue;
+        }
+        for (size_t j = 0; j < other._odds.size(); j++) {
+            result._odds[i + j] += _odds[i] * other._odds[j];
+        }
+    }
+    return result;
+}
+
+Distribution Distribution::shifted(int offset) const {
+    Distribution result{ *this };
+    result._offset += offset;
+    return result;
+}
+
+Distribution Distribution::scaled(int factor) const {
+    Distribution result{};
+    result._offset = _offset * factor;
+    result._odds.assign((_odds.size() - 1) * static_cast<size_t>(factor) + 1, 0.0);
+    for (size_t i = 0; i < _odds.size(); i++) {
+        result._odds[i * static_cast<size_t>(factor)] = _odds[i];
+    }
+    return result;
+}
+
+Distribution Distribution::repeated(int count) const {
+    // Exponentiation by squaring, so only a logarithmic amount of convolutions is needed
+    Distribution result{};
+    Distribution power{ *this };
+    while (count > 0) {
+        if (count & 1) {
+            result = result + power;
+        }
+        count >>= 1;
+        if (count > 0) {
+            power = power + power;
+        }
+    }
+    return result;
+}
+
+double Distribution::at_least(int value) const {
+    double chance{};
+    for (size_t i = 0; i < _odds.size(); i++) {
+        if (_offset + static_cast<int>(i) >= value) {
+            chance += _odds[i];
+        }
+    }
+    return chance;
+}
+
+double Distribution::mean() const {
+    double sum{};
+    for (size_t i = 0; i < _odds.size(); i++) {
+        sum += _odds[i] * (_offset + static_cast<int>(i));
+    }
+    return sum;
+}
+
+double Distribution::variance() const {
+    double average = mean();
+    double sum{};
+    for (size_t i = 0; i < _odds.size(); i++) {
+        double difference = _offset + static_cast<int>(i) - average;
+        sum += _odds[i] * difference * difference;
+    }
+    return sum;
+}
\ No newline at end of file
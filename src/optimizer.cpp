@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <tuple>
+#include "optimizer.hpp"
+#include "probability.hpp"
+#include "simulator.hpp"
+
+Optimizer::Optimizer(const std::vector<std::pair<int, double>> &targets, int hp, uint64_t seed) : _targets{ targets }, _hp{ hp } {
+    _roller.seed(seed);
+    // Normalize the weights so they can be used as chances
+    double total{};
+    for (const auto &[ac, weight] : _targets) {
+        total += weight;
+    }
+    for (auto &[ac, weight] : _targets) {
+        weight /= total;
+    }
+}
+
+void Optimizer::run(const std::vector<RollVals> &candidates) {
+    _results.clear();
+    double best_lower{};
+    for (const RollVals &vals : candidates) {
+        CandidateResult result{};
+        // Candidates are scored against the target ACs, their own AC is only a placeholder then
+        result.description = Simulator::describe(vals, _targets.empty());
+        std::tie(result.lower, result.upper) = bounds(vals);
+        best_lower = std::max(best_lower, result.lower);
+        _results.push_back(result);
+    }
+    // Only candidates that can still beat the best guaranteed score are evaluated
+    for (size_t i = 0; i < candidates.size(); i++) {
+        CandidateResult &result = _results.at(i);
+        if (result.upper < best_lower) {
+            result.pruned = true;
+            continue;
+        }
+        // Equal bounds already are the exact score
+        if (result.lower == result.upper) {
+            result.value = result.lower;
+            continue;
+        }
+        result.value = evaluate(candidates.at(i), result.sampled);
+    }
+    // Pruned candidates are ranked by their upper bound, so they never sit below a candidate they may beat
+    std::stable_sort(_results.begin(), _results.end(), [](const CandidateResult &a, const CandidateResult &b) {
+        return (a.pruned ? a.upper : a.value) > (b.pruned ? b.upper : b.value);
+    });
+}
+
+void Optimizer::report() const {
+    if (_hp > 0) {
+        std::cout << "Ranking " << _results.size() << " candidates by chance to deal at least " << _hp << " damage";
+    }
+    else {
+        std::cout << "Ranking " << _results.size() << " candidates by expected damage";
+    }
+    if (!_targets.empty()) {
+        std::cout << " against";
+        for (size_t i = 0; i < _targets.size(); i++) {
+            std::cout << (i == 0 ? " " : ", ") << "AC " << _targets.at(i).first << " (" << std::fixed << std::setprecision(0)
+                      << 100.0 * _targets.at(i).second << "%)";
+        }
+    }
+    std::cout << std::endl;
+    // Kill chances are printed as a percentage, expected damage as is
+    double scale = _hp > 0 ? 100.0 : 1.0;
+    std::string unit = _hp > 0 ? "%" : " damage";
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < _results.size(); i++) {
+        const CandidateResult &result = _results.at(i);
+        if (result.pruned) {
+            std::cout << "-. at most " << scale * result.upper << unit << " (pruned): " << result.description << std::endl;
+            continue;
+        }
+        std::cout << i + 1 << ". " << scale * result.value << unit;
+        if (result.sampled) {
+            std::cout << " (sampled)";
+        }
+        std::cout << ": " << result.description << std::endl;
+    }
+    // Sampled scores can be reproduced with --seed
+    if (std::any_of(_results.begin(), _results.end(), [](const CandidateResult &result) { return result.sampled; })) {
+        std::cout << "Sampled with seed: " << _roller.seed() << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
+std::vector<std::pair<double, RollVals>> Optimizer::against_targets(const RollVals &vals) const {
+    std::vector<std::pair<double, RollVals>> targets{};
+    if (_targets.empty()) {
+        targets.push_back({ 1.0, vals });
+    }
+    for (const auto &[ac, weight] : _targets) {
+        RollVals target{ vals };
+        target.ac = ac;
+        targets.push_back({ weight, target });
+    }
+    return targets;
+}
+
+std::pair<double, double> Optimizer::bounds(const RollVals &vals) const {
+    double lower{};
+    double upper{};
+    for (const auto &[weight, target] : against_targets(vals)) {
+        DamageMoments moments = damage_moments(target);
+        // Expected damage is known exactly from the moments
+        if (_hp <= 0) {
+            lower += weight * moments.mean;
+            upper += weight * moments.mean;
+        }
+        else if (moments.max < _hp) {
+            continue;
+        }
+        else if (moments.min >= _hp) {
+            lower += weight;
+            upper += weight;
+        }
+        // Cantelli's inequality bounds the kill chance by how far the hit points are from the mean
+        else if (_hp > moments.mean) {
+            double distance = _hp - moments.mean;
+            upper += weight * moments.variance / (moments.variance + distance * distance);
+        }
+        else {
+            double distance = moments.mean - _hp;
+            lower += weight * (1.0 - moments.variance / (moments.variance + distance * distance));
+            upper += weight;
+        }
+    }
+    return { lower, upper };
+}
+
+double Optimizer::evaluate(const RollVals &vals, bool &sampled) {
+    double score{};
+    std::vector<std::pair<double, RollVals>> targets = against_targets(vals);
+    for (size_t index = 0; index < targets.size(); index++) {
+        const auto &[weight, target] = targets.at(index);
+        DamageMoments moments = damage_moments(target);
+        if (_hp <= 0) {
+            score += weight * moments.mean;
+        }
+        // Small enough totals are convolved exactly
+        else if (moments.max - moments.min < EXACT_SIZE_LIMIT) {
+            score += weight * damage_distribution(target).at_least(_hp);
+        }
+        // Otherwise the kill chance is estimated from aggregate rolls
+        else {
+            sampled = true;
+            _roller.set_vals(target);
+            int kills{};
+            for (int i = 0; i < OPTIMIZE_SAMPLES; i++) {
+                // Every sample has its own position, all candidates use the same positions per target so they are compared on the same draws
+                _roller.set_position(index, static_cast<uint64_t>(i));
+                RollTotals totals = _roller.roll_aggregate();
+                int64_t total{};
+                for (const auto &[type, value] : totals.damage) {
+                    total += value;
+                }
+                if (total >= _hp) {
+                    kills++;
+                }
+            }
+            score += weight * kills / OPTIMIZE_SAMPLES;
+        }
+    }
+    return score;
+}
\ No newline at end of file
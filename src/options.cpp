@@ -1,7 +1,9 @@
 #include "options.hpp"
+#include "dice.hpp"
 #include <filesystem>
 #include <stdexcept>
 #include <regex>
+#include <sstream>
 #include <iostream>
 
 void Options::parse(int argc, char **argv) {
@@ -24,18 +26,19 @@ void Options::parse(int argc, char **argv) {
                 for (auto j = begin; j != end; j++) {
                     Damage damage;
                     std::smatch match = *j;
-                    if (match.size() < 5) {
+                    if (match.size() < 6) {
                         throw std::invalid_argument("Invalid damage format: " + arg);
                     }
                     damage.dice_count = std::stoi(match[1].str());
                     damage.dice_sides = std::stoi(match[2].str());
-                    std::string temp = match[3].matched ? match[3].str() : "0";
+                    parse_dice_modifiers(match[3].str(), damage);
+                    std::string temp = match[4].matched ? match[4].str() : "0";
                     size_t idx = temp.find_first_of(" \t\r\n");
                     if (idx != std::string::npos) {
                         temp.erase(temp.find_first_of(" \t\r\n"), 1);
                     }
                     damage.modifier = std::stoi(temp);
-                    damage.type = match[4].str();
+                    damage.type = match[5].str();
                     _vals.damages.push_back(damage);
                 }
             }
@@ -120,6 +123,186 @@ void Options::parse(int argc, char **argv) {
                 throw std::invalid_argument("No critical range provided after --crit-range");
             }
         }
+        // Check for the --totals-only option
+        else if (arg == "--totals-only") {
+            _totals_only = true;
+        }
+        // Check for the --optimize option
+        else if (arg == "--optimize") {
+            _optimize = true;
+        }
+        // Check for the --sensitivity option
+        else if (arg == "--sensitivity") {
+            _sensitivity = true;
+        }
+        // Check for the --ac-dist option and parse the list of ACs with optional weights
+        else if (arg == "--ac-dist") {
+            if (i + 1 < argc) {
+                std::string dist = argv[++i];
+                std::regex target_regex{ R"(\s*(\d+)\s*(?::\s*(\d+(?:\.\d+)?))?\s*)" };
+                // Every comma separated entry must be a whole target, so malformed entries aren't skipped
+                std::istringstream entries{ dist };
+                std::string entry{};
+                while (std::getline(entries, entry, ',')) {
+                    std::smatch match{};
+                    if (!std::regex_match(entry, match, target_regex)) {
+                        throw std::invalid_argument("Invalid AC distribution entry: " + entry);
+                    }
+                    try {
+                        int ac = std::stoi(match[1].str());
+                        double weight = match[2].matched ? std::stod(match[2].str()) : 1.0;
+                        if (ac < 1 || weight <= 0.0) {
+                            throw std::invalid_argument(entry);
+                        }
+                        _ac_dist.push_back({ ac, weight });
+                    }
+                    catch (const std::logic_error &) {
+                        throw std::invalid_argument("Invalid AC distribution value: " + entry);
+                    }
+                }
+                // An empty list or a trailing comma leaves an empty entry that getline doesn't return
+                if (dist.empty() || dist.back() == ',') {
+                    throw std::invalid_argument("Invalid AC distribution format: " + dist);
+                }
+            }
+            else {
+                throw std::invalid_argument("No AC distribution provided after --ac-dist");
+            }
+        }
+        // Check for the --hp option and parse the target hit points
+        else if (arg == "--hp") {
+            if (i + 1 < argc) {
+                try {
+                    _hp = std::stoi(argv[++i]);
+                    if (_hp < 1) {
+                        throw std::invalid_argument(argv[i]);
+                    }
+                }
+                catch (const std::logic_error &e) {
+                    throw std::invalid_argument("Invalid HP value: " + std::string(argv[i]));
+                }
+            }
+            else {
+                throw std::invalid_argument("No HP provided after --hp");
+            }
+        }
+        // Check for the --simulate option and parse the amount of trials
+        else if (arg == "--simulate") {
+            if (i + 1 < argc) {
+                try {
+                    long long trials = std::stoll(argv[++i]);
+                    if (trials < 1) {
+                        throw std::invalid_argument(argv[i]);
+                    }
+                    _trials = static_cast<uint64_t>(trials);
+                }
+                catch (const std::logic_error &e) {
+                    throw std::invalid_argument("Invalid amount of trials: " + std::string(argv[i]));
+                }
+            }
+            else {
+                throw std::invalid_argument("No amount of trials provided after --simulate");
+            }
+        }
+        // Check for the --seed option and parse the seed value
+        else if (arg == "--seed") {
+            if (i + 1 < argc) {
+                try {
+                    _seed = std::stoull(argv[++i]);
+                }
+                catch (const std::logic_error &e) {
+                    throw std::invalid_argument("Invalid seed value: " + std::string(argv[i]));
+                }
+            }
+            else {
+                throw std::invalid_argument("No seed provided after --seed");
+            }
+        }
+        // Check for the --replay option and parse the seed and attack file of the session to replay
+        else if (arg == "--replay") {
+            if (i + 2 < argc) {
+                try {
+                    _seed = std::stoull(argv[++i]);
+                }
+                catch (const std::logic_error &e) {
+                    throw std::invalid_argument("Invalid seed value: " + std::string(argv[i]));
+                }
+                std::string file = argv[++i];
+                if (!std::filesystem::exists(file)) {
+                    throw std::invalid_argument("File does not exist: " + file + ".");
+                }
+                _opts_files.push_back(file);
+            }
+            else {
+                throw std::invalid_argument("No seed and file provided after --replay");
+            }
+        }
+        // Check for the --shard option and parse the shard in the format i/N
+        else if (arg == "--shard") {
+            if (i + 1 < argc) {
+                std::string shard = argv[++i];
+                std::smatch match;
+                if (!std::regex_match(shard, match, std::regex{ R"((\d+)/(\d+))" })) {
+                    throw std::invalid_argument("Invalid shard format: " + shard);
+                }
+                try {
+                    _shard_index = std::stoi(match[1].str());
+                    _shard_count = std::stoi(match[2].str());
+                }
+                catch (const std::out_of_range &e) {
+                    throw std::invalid_argument("Invalid shard value: " + shard);
+                }
+                if (_shard_count < 1 || _shard_index >= _shard_count) {
+                    throw std::invalid_argument("Invalid shard value: " + shard);
+                }
+            }
+            else {
+                throw std::invalid_argument("No shard provided after --shard");
+            }
+        }
+        // Check for the --partial option and store the file to write partial results to
+        else if (arg == "--partial") {
+            if (i + 1 < argc) {
+                _partial_file = argv[++i];
+            }
+            else {
+                throw std::invalid_argument("No file provided after --partial");
+            }
+        }
+        // Check for the --merge option and collect all partial result files following it
+        else if (arg == "--merge") {
+            while (i + 1 < argc && !std::string(argv[i + 1]).starts_with("-")) {
+                std::string file = argv[++i];
+                if (!std::filesystem::exists(file)) {
+                    throw std::invalid_argument("File does not exist: " + file + ".");
+                }
+                _merge_files.push_back(file);
+            }
+            if (_merge_files.empty()) {
+                throw std::invalid_argument("No partial result files provided after --merge");
+            }
+        }
+        // Check for the --audit option and store the file to write the audit log to
+        else if (arg == "--audit") {
+            if (i + 1 < argc) {
+                _audit_file = argv[++i];
+            }
+            else {
+                throw std::invalid_argument("No file provided after --audit");
+            }
+        }
+        // Check for the --read-audit option and store the audit log file to decode
+        else if (arg == "--read-audit") {
+            if (i + 1 < argc) {
+                _read_audit_file = argv[++i];
+                if (!std::filesystem::exists(_read_audit_file)) {
+                    throw std::invalid_argument("File does not exist: " + _read_audit_file + ".");
+                }
+            }
+            else {
+                throw std::invalid_argument("No file provided after --read-audit");
+            }
+        }
         // Check for short options starting with a single dash
         else if (arg.starts_with("-") && !arg.starts_with("--")) {
             for (char c : arg.substr(1)) {
@@ -144,6 +327,46 @@ void Options::parse(int argc, char **argv) {
 }
 
 void Options::check_opts() {
+    // Check if the simulation options are consistent
+    if (_shard_count > 1 && _trials == 0) {
+        throw std::invalid_argument("shard was passed without simulate, nothing to split.");
+    }
+    if (_shard_count > 1 && !_seed) {
+        throw std::invalid_argument("shard was passed without seed, shards of different runs can\'t be merged.");
+    }
+    if (!_audit_file.empty() && (_totals_only || _optimize || _sensitivity)) {
+        throw std::invalid_argument("audit can\'t be combined with totals-only, optimize or sensitivity, they don\'t roll every die.");
+    }
+    if (!_read_audit_file.empty()) {
+        if (_trials != 0 || _optimize || !_merge_files.empty() || !_opts_files.empty() || !_audit_file.empty()) {
+            throw std::invalid_argument("read-audit can\'t be combined with other modes.");
+        }
+        _only_files = true;
+        return;
+    }
+    if (!_merge_files.empty()) {
+        if (_trials != 0 || !_opts_files.empty()) {
+            throw std::invalid_argument("merge can\'t be combined with rolling or simulating attack(s).");
+        }
+        _only_files = true;
+        return;
+    }
+    if (_optimize && _trials != 0) {
+        throw std::invalid_argument("optimize can\'t be combined with simulate.");
+    }
+    if (_sensitivity && (_optimize || _trials != 0)) {
+        throw std::invalid_argument("sensitivity can\'t be combined with optimize or simulate.");
+    }
+    if ((!_ac_dist.empty() || _hp != 0) && !_optimize) {
+        throw std::invalid_argument("ac-dist and hp are only used with optimize.");
+    }
+    // The optimizer replaces the AC of every candidate with the target ACs
+    if (!_ac_dist.empty() && _vals.ac == 0) {
+        _vals.ac = _ac_dist.front().first;
+    }
+    if (!_partial_file.empty() && _trials == 0) {
+        throw std::invalid_argument("partial was passed without simulate, there are no results to write.");
+    }
     // Check if the required options are set
     // _modifier can be 0, so is not checked here
     if (_opts_files.size() == 0 && !_help) {
@@ -167,22 +390,38 @@ void Options::help_msg() {
               << "Options:" << std::endl
               << "  --help or -h            Show this help message" << std::endl
               << "  --damage <dmg>          Specify damage (format: 1d6 + 7 piercing + 1d6 poison)" << std::endl
+              << "                          Dice can be followed by r<n> (reroll n or lower once), m<n> (treat lower rolls as n)," << std::endl
+              << "                          kh<n> (keep the highest n dice) and ! (exploding, at most " << EXPLODE_LIMIT << " extra dice), e.g. 2d6r2" << std::endl
               << "  --modifier <mod>        Specify attack modifier value" << std::endl
               << "  --attack-count <count>  Specify number of attacks" << std::endl
               << "  --ac <ac>               Specify target's Armor Class" << std::endl
               << "  --attack-type <type>    Specify attack type (A or a for Advantage, D or d for Disadvantage, N or n for Normal)" << std::endl
               << "  --crit-range <range>    Specify critical hit range (default is 20)" << std::endl
+              << "  --totals-only           Only print the total damage, drawing it for all attacks at once (much faster for many attacks)" << std::endl
+              << "  --sensitivity           Print how expected damage changes with +1 to hit, damage or dice, a wider crit range and advantage" << std::endl
+              << "  --audit <file>          Write every rolled d20 and damage die to a binary audit log" << std::endl
+              << "  --read-audit <file>     Decode an audit log and print every attack in it" << std::endl
+              << "  --optimize              Rank all attack sets by expected damage (or kill chance with --hp) instead of rolling them" << std::endl
+              << "  --ac-dist <acs>         Target ACs for --optimize with optional weights (format: 15:1,17:2,19:1)" << std::endl
+              << "  --hp <hp>               Rank --optimize candidates by the chance to deal at least <hp> damage" << std::endl
+              << "  --simulate <trials>     Simulate every attack set <trials> times and print a damage report" << std::endl
+              << "  --seed <seed>           Specify the seed of the rolls, the same seed and options give the same rolls (random if not passed)" << std::endl
+              << "  --replay <seed> <file>  Roll the attack file again exactly as the session with this seed did" << std::endl
+              << "  --shard <i/N>           Only run shard i (0 based) of N of the simulation trials, requires --seed" << std::endl
+              << "  --partial <file>        Write the simulation results to a partial result file instead of printing them" << std::endl
+              << "  --merge <files...>      Merge partial result files and print the report (or write it with --partial)" << std::endl
               << std::endl
               << "File formatting:" << std::endl
               << "  attacks:<amount of attacks>     format: integer greater than 0" << std::endl
               << "  modifier:<attack modifier>      format: integer" << std::endl
               << "  crit range:<crit range>         format: integer between 1 and 20" << std::endl
-              << "  damage:<damage format>          format: 1d6 + 7 piercing + 1d6 poison" << std::endl
+              << "  damage:<damage format>          format: 1d6 + 7 piercing + 1d6 poison, dice modifiers as in --damage" << std::endl
               << "  ac:<ac>                         format: integer greater than 0" << std::endl
               << "  attack type:<attack type>       format: A or a for Advantage, D or d for Disadvantage, N or n for Normal" << std::endl
               << std::endl
               << "Above values can be in any order." << std::endl
               << "All values except \"crit range\", \"ac\" and \"attack type\"  must be present or program will exit." << std::endl
+              << "Missing \"ac\" and \"attack type\" values are taken from --ac and --attack-type, otherwise they are asked once for all attack sets before rolling." << std::endl
               << "Seperate blocks must be seperated by a linebreak and there can be an practically infinite amount of blocks" << std::endl;
 }
 
@@ -234,19 +473,20 @@ void Options::set_damages() {
             for (auto i = begin; i != end; i++) {
                 Damage damage;
                 std::smatch match = *i;
-                if (match.size() < 5) {
+                if (match.size() < 6) {
                     throw std::invalid_argument(input);
                 }
                 damage.dice_count = std::stoi(match[1].str());
                 damage.dice_sides = std::stoi(match[2].str());
-                std::string temp = match[3].matched ? match[3].str() : "0";
+                parse_dice_modifiers(match[3].str(), damage);
+                std::string temp = match[4].matched ? match[4].str() : "0";
                 size_t idx = temp.find_first_of(" \t\r\n");
                 // If there is a space or tab in the modifier, remove it
                 if (idx != std::string::npos) {
                     temp.erase(temp.find_first_of(" \t\r\n"), 1);
                 }
                 damage.modifier = std::stoi(temp);
-                damage.type = match[4].str();
+                damage.type = match[5].str();
                 _vals.damages.push_back(damage);
             }
             break;
@@ -0,0 +1,33 @@
+#include "philox.hpp"
+
+void Philox::seed(uint64_t seed) {
+    _seed = seed;
+    seek(0, 0, 0);
+}
+
+void Philox::seek(uint64_t set, uint64_t offset, uint32_t attack) {
+    // The attack set moves the key by an odd constant, so every set of a seed gets a different key
+    // and the roll (or trial) can use two full words of the counter
+    uint64_t key = _seed + set * SET_STEP;
+    _key = { static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32) };
+    _die = 0;
+    _counter = { 0, attack, static_cast<uint32_t>(offset), static_cast<uint32_t>(offset >> 32) };
+    _used = WORDS;
+}
+
+void Philox::generate() {
+    // Ten rounds of Philox4x32 with the standard multipliers and Weyl key increments
+    std::array<uint32_t, 4> block = _counter;
+    std::array<uint32_t, 2> key = _key;
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * block[0];
+        uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * block[2];
+        block = { static_cast<uint32_t>(product1 >> 32) ^ block[1] ^ key[0], static_cast<uint32_t>(product1),
+                  static_cast<uint32_t>(product0 >> 32) ^ block[3] ^ key[1], static_cast<uint32_t>(product0) };
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    _block = block;
+    _counter[0]++;
+    _used = 0;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "probability.hpp"
+#include "dice.hpp"
+
+std::array<double, D20 + 1> d20_odds(AttackType attack_type) {
+    std::array<double, D20 + 1> odds{};
+    double sides = D20;
+    for (int value = 1; value <= D20; value++) {
+        double v = value;
+        if (attack_type == ADVANTAGE) {
+            // Chance that the highest of two dice is exactly value
+            odds[value] = (v * v - (v - 1) * (v - 1)) / (sides * sides);
+        }
+        else if (attack_type == DISADVANTAGE) {
+            // Chance that the lowest of two dice is exactly value
+            odds[value] = ((sides - v + 1) * (sides - v + 1) - (sides - v) * (sides - v)) / (sides * sides);
+        }
+        else {
+            odds[value] = 1.0 / sides;
+        }
+    }
+    return odds;
+}
+
+OutcomeOdds outcome_odds(const RollVals &vals) {
+    std::array<double, D20 + 1> odds = d20_odds(vals.attack_type);
+    OutcomeOdds outcome{};
+    for (int roll = 1; roll <= D20; roll++) {
+        // Same hit and crit conditions as DiceRoller::roll()
+        if (((roll + vals.modifier) >= vals.ac || roll == CRIT) && roll != CRIT_MISS) {
+            if (roll >= vals.crit_range) {
+                outcome.crit += odds[roll];
+            }
+            else {
+                outcome.hit += odds[roll];
+            }
+        }
+        else {
+            outcome.miss += odds[roll];
+        }
+    }
+    return outcome;
+}
+
+HitMoments hit_moments(const Damage &damage) {
+    HitMoments moments{};
+    if (is_modified(damage)) {
+        Distribution unit = unit_distribution(damage);
+        int units = dice_units(damage);
+        moments.mean = units * unit.mean();
+        moments.variance = units * unit.variance();
+        moments.min = static_cast<int64_t>(units) * unit.min();
+        moments.max = static_cast<int64_t>(units) * unit.max();
+    }
+    else {
+        double sides = damage.dice_sides;
+        moments.mean = damage.dice_count * (sides + 1.0) / 2.0;
+        moments.variance = damage.dice_count * (sides * sides - 1.0) / 12.0;
+        moments.min = damage.dice_count;
+        moments.max = static_cast<int64_t>(damage.dice_count) * damage.dice_sides;
+    }
+    moments.modifier = damage.modifier;
+    return moments;
+}
+
+HitMoments hit_moments(const RollVals &vals) {
+    // The dice of different damages are independent, so their moments add up
+    HitMoments moments{};
+    for (const Damage &damage : vals.damages) {
+        HitMoments current = hit_moments(damage);
+        moments.mean += current.mean;
+        moments.variance += current.variance;
+        moments.min += current.min;
+        moments.max += current.max;
+        moments.modifier += current.modifier;
+    }
+    return moments;
+}
+
+DamageMoments combine_moments(const OutcomeOdds &odds, const HitMoments &hit, int attack_count) {
+    // A hit deals dice + modifier, a crit deals twice the dice + modifier
+    double hit_mean = hit.mean + hit.modifier;
+    double crit_mean = CRIT_MULTIPLIER * hit.mean + hit.modifier;
+    double mean = odds.hit * hit_mean + odds.crit * crit_mean;
+    double square = odds.hit * (hit.variance + hit_mean * hit_mean)
+        + odds.crit * (CRIT_MULTIPLIER * CRIT_MULTIPLIER * hit.variance + crit_mean * crit_mean);
+    // A critical miss is always possible, so a single attack can always deal 0 damage
+    int64_t attack_min{};
+    int64_t attack_max{};
+    if (odds.hit > 0.0) {
+        attack_min = std::min(attack_min, hit.min + hit.modifier);
+        attack_max = std::max(attack_max, hit.max + hit.modifier);
+    }
+    if (odds.crit > 0.0) {
+        attack_min = std::min(attack_min, CRIT_MULTIPLIER * hit.min + hit.modifier);
+        attack_max = std::max(attack_max, CRIT_MULTIPLIER * hit.max + hit.modifier);
+    }
+    DamageMoments moments{};
+    moments.mean = attack_count * mean;
+    moments.variance = attack_count * std::max(square - mean * mean, 0.0);
+    moments.min = attack_count * attack_min;
+    moments.max = attack_count * attack_max;
+    return moments;
+}
+
+DamageMoments damage_moments(const RollVals &vals) {
+    return combine_moments(outcome_odds(vals), hit_moments(vals), vals.attack_count);
+}
+
+void check_damage_range(const RollVals &vals) {
+    // Upper bound of the damage of a single attack, exploding dice can roll at most EXPLODE_LIMIT extra dice each
+    double attack_max{};
+    for (const Damage &damage : vals.damages) {
+        double dice_max = static_cast<double>(damage.dice_count) * damage.dice_sides * (damage.explode ? EXPLODE_LIMIT + 1 : 1);
+        attack_max += CRIT_MULTIPLIER * dice_max + std::abs(damage.modifier);
+    }
+    if (vals.attack_count * attack_max > static_cast<double>(std::numeric_limits<int64_t>::max())) {
+        throw std::invalid_argument("The total damage of " + std::to_string(vals.attack_count) + " attacks of " + std::to_string(static_cast<int64_t>(attack_max)) + " damage is too large to count.");
+    }
+}
+
+Distribution attack_distribution(const RollVals &vals) {
+    OutcomeOdds odds = outcome_odds(vals);
+    Distribution dice{};
+    int modifier{};
+    for (const Damage &damage : vals.damages) {
+        dice = dice + dice_distribution(damage);
+        modifier += damage.modifier;
+    }
+    return Distribution::mixture({ { odds.miss, Distribution{} },
+                                   { odds.hit, dice.shifted(modifier) },
+                                   { odds.crit, dice.scaled(CRIT_MULTIPLIER).shifted(modifier) } });
+}
+
+Distribution damage_distribution(const RollVals &vals) {
+    return attack_distribution(vals).repeated(vals.attack_count);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "sensitivity.hpp"
+#include "probability.hpp"
+#include "dice.hpp"
+#include "simulator.hpp"
+
+void Sensitivity::run(const std::vector<RollVals> &sets) {
+    _descriptions.clear();
+    _results.clear();
+    for (const RollVals &vals : sets) {
+        _descriptions.push_back(Simulator::describe(vals));
+        _results.push_back(analyze(vals));
+    }
+}
+
+void Sensitivity::report() const {
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < _results.size(); i++) {
+        const std::vector<SensitivityResult> &results = _results.at(i);
+        const SensitivityResult &base = results.front();
+        std::cout << "Sensitivity of attack set " << i + 1 << ": " << _descriptions.at(i) << std::endl
+                  << "Base: expected damage " << base.mean << ", std dev " << std::sqrt(base.variance) << std::endl;
+        for (size_t j = 1; j < results.size(); j++) {
+            const SensitivityResult &result = results.at(j);
+            std::cout << result.change << ": expected damage " << result.mean << " (" << std::showpos << result.mean - base.mean
+                      << std::noshowpos << "), std dev " << std::sqrt(result.variance) << " (variance " << std::showpos
+                      << result.variance - base.variance << std::noshowpos << ")" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
+std::vector<SensitivityResult> Sensitivity::analyze(const RollVals &vals) {
+    std::vector<SensitivityResult> results{};
+    auto add = [&results](const std::string &change, const DamageMoments &moments) {
+        results.push_back({ change, moments.mean, moments.variance });
+    };
+    // Base evaluation: chance of every d20 value, outcome chances and the moments of a single hit
+    std::array<double, D20 + 1> faces = d20_odds(vals.attack_type);
+    OutcomeOdds odds = outcome_odds(vals);
+    HitMoments hit = hit_moments(vals);
+    add("Base", combine_moments(odds, hit, vals.attack_count));
+
+    // +1 to hit only turns the d20 value that missed by exactly one into a hit (or crit)
+    OutcomeOdds to_hit = odds;
+    int face = vals.ac - vals.modifier - 1;
+    if (face > CRIT_MISS && face < CRIT) {
+        to_hit.miss -= faces[face];
+        (face >= vals.crit_range ? to_hit.crit : to_hit.hit) += faces[face];
+    }
+    add("+1 to hit (or -1 AC)", combine_moments(to_hit, hit, vals.attack_count));
+
+    // +1 flat damage is added once per hit, also on crits
+    HitMoments flat = hit;
+    flat.modifier += 1;
+    add("+1 flat damage", combine_moments(odds, flat, vals.attack_count));
+
+    // One more die only changes the moments of that damage, a keep highest pool gets one more die to keep from
+    for (const Damage &damage : vals.damages) {
+        Damage more_dice = damage;
+        more_dice.dice_count++;
+        HitMoments before = hit_moments(damage);
+        HitMoments after = hit_moments(more_dice);
+        HitMoments more = hit;
+        more.mean += after.mean - before.mean;
+        more.variance += after.variance - before.variance;
+        more.min += after.min - before.min;
+        more.max += after.max - before.max;
+        add("+1 die on " + dice_notation(damage) + " " + damage.type, combine_moments(odds, more, vals.attack_count));
+    }
+
+    // Expanding the crit range turns hits with the next lower d20 value into crits, misses stay misses
+    int crit_face = vals.crit_range - 1;
+    if (crit_face > CRIT_MISS) {
+        OutcomeOdds crit = odds;
+        if (crit_face + vals.modifier >= vals.ac) {
+            crit.hit -= faces[crit_face];
+            crit.crit += faces[crit_face];
+        }
+        add("Crit range " + std::to_string(crit_face) + "-" + std::to_string(CRIT), combine_moments(crit, hit, vals.attack_count));
+    }
+
+    // Advantage (or losing disadvantage) only changes the chances of the d20 values
+    if (vals.attack_type != ADVANTAGE) {
+        RollVals better = vals;
+        better.attack_type = vals.attack_type == DISADVANTAGE ? NORMAL : ADVANTAGE;
+        add(vals.attack_type == DISADVANTAGE ? "Without disadvantage" : "Advantage",
+            combine_moments(outcome_odds(better), hit, vals.attack_count));
+    }
+    return results;
+}
\ No newline at end of file
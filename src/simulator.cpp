@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "simulator.hpp"
+#include "dice.hpp"
+
+/// @brief Calculates the amount of trials of a shard, the first (trials % shard_count) shards get one extra trial.
+/// @param trials Total amount of trials over all shards.
+/// @param shard_count Amount of shards the trials are split into.
+/// @param index Zero based index of the shard.
+/// @return Amount of trials of the shard.
+static uint64_t shard_trials(uint64_t trials, uint64_t shard_count, uint64_t index) {
+    return trials / shard_count + (index < trials % shard_count ? 1 : 0);
+}
+
+Simulator::Simulator(uint64_t seed, uint64_t trials, int shard_index, int shard_count) {
+    _result.seed = seed;
+    _result.trials = trials;
+    _result.shard_count = shard_count;
+    _result.shards.push_back(shard_index);
+}
+
+void Simulator::run(const std::vector<RollVals> &sets) {
+    // Split the trials as evenly as possible, the first (trials % shard_count) shards get one extra trial
+    uint64_t count = static_cast<uint64_t>(_result.shard_count);
+    uint64_t index = static_cast<uint64_t>(_result.shards.front());
+    uint64_t begin = (_result.trials / count) * index + std::min(index, _result.trials % count);
+    uint64_t end = begin + shard_trials(_result.trials, count, index);
+    _result.runs = end - begin;
+
+    for (size_t set = 0; set < sets.size(); set++) {
+        const RollVals &vals = sets.at(set);
+        SetResult set_result{};
+        set_result.description = describe(vals);
+        // Every damage type gets a histogram entry each trial, also when all attacks missed
+        for (const Damage &damage : vals.damages) {
+            set_result.damage[damage.type];
+        }
+        _roller.set_vals(vals);
+        _roller.seed(_result.seed);
+        for (uint64_t trial = begin; trial < end; trial++) {
+            // The dice of a trial only depend on the seed and its position, so the result doesn't depend on how the trials are sharded
+            _roller.set_position(set, trial);
+            RollTotals totals = _result.totals_only ? _roller.roll_aggregate() : _roller.roll_totals();
+            set_result.hits += static_cast<uint64_t>(totals.hits);
+            set_result.crits += static_cast<uint64_t>(totals.crits);
+            set_result.misses += static_cast<uint64_t>(totals.misses);
+            for (auto &[type, stats] : set_result.damage) {
+                int64_t value = totals.damage[type];
+                stats.sum += value;
+                stats.histogram[value]++;
+            }
+        }
+        _result.sets.push_back(set_result);
+    }
+}
+
+void Simulator::merge(const std::string &file_name) {
+    SimResult partial = read(file_name);
+    // The first partial file determines the simulation the others must belong to
+    if (_result.shards.empty()) {
+        _result = partial;
+        return;
+    }
+    // Drawing the totals at once uses other dice than rolling every attack, so the modes can't be mixed either
+    if (partial.seed != _result.seed || partial.trials != _result.trials || partial.shard_count != _result.shard_count
+        || partial.totals_only != _result.totals_only) {
+        throw std::invalid_argument("Partial result file " + file_name + " belongs to a different simulation.");
+    }
+    if (partial.sets.size() != _result.sets.size()) {
+        throw std::invalid_argument("Partial result file " + file_name + " has a different amount of attack sets.");
+    }
+    for (int shard : partial.shards) {
+        if (std::find(_result.shards.begin(), _result.shards.end(), shard) != _result.shards.end()) {
+            throw std::invalid_argument("Shard " + std::to_string(shard) + " in " + file_name + " was already merged.");
+        }
+    }
+    for (size_t i = 0; i < partial.sets.size(); i++) {
+        SetResult &set_result = _result.sets.at(i);
+        const SetResult &other = partial.sets.at(i);
+        if (other.description != set_result.description) {
+            throw std::invalid_argument("Attack set " + std::to_string(i + 1) + " in " + file_name + " differs from the merged attack set.");
+        }
+        set_result.hits += other.hits;
+        set_result.crits += other.crits;
+        set_result.misses += other.misses;
+        for (const auto &[type, stats] : other.damage) {
+            DamageStats &merged = set_result.damage[type];
+            merged.sum += stats.sum;
+            for (const auto &[value, count] : stats.histogram) {
+                merged.histogram[value] += count;
+            }
+        }
+    }
+    _result.shards.insert(_result.shards.end(), partial.shards.begin(), partial.shards.end());
+    std::sort(_result.shards.begin(), _result.shards.end());
+    _result.runs += partial.runs;
+}
+
+void Simulator::save(const std::string &file_name) const {
+    std::ofstream file{ file_name };
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    file << "partial:5" << std::endl
+         << "seed:" << _result.seed << std::endl
+         << "trials:" << _result.trials << std::endl
+         << "mode:" << (_result.totals_only ? "totals" : "attacks") << std::endl
+         << "shards:" << _result.shard_count << std::endl
+         << "shard:";
+    for (size_t i = 0; i < _result.shards.size(); i++) {
+        file << (i == 0 ? "" : " ") << _result.shards.at(i);
+    }
+    file << std::endl
+         << "runs:" << _result.runs << std::endl;
+    for (const SetResult &set_result : _result.sets) {
+        file << "set:" << set_result.description << std::endl
+             << "hits:" << set_result.hits << std::endl
+             << "crits:" << set_result.crits << std::endl
+             << "misses:" << set_result.misses << std::endl;
+        for (const auto &[type, stats] : set_result.damage) {
+            file << "damage:" << type << std::endl
+                 << "sum:" << stats.sum << std::endl
+                 << "histogram:";
+            // Histogram is written as value=count pairs, only values that occurred are stored
+            bool first{ true };
+            for (const auto &[value, count] : stats.histogram) {
+                file << (first ? "" : " ") << value << "=" << count;
+                first = false;
+            }
+            file << std::endl;
+        }
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Could not write to file: " + file_name);
+    }
+}
+
+void Simulator::report() const {
+    std::cout << "Simulated " << _result.runs << " of " << _result.trials << " trials with seed: " << _result.seed << std::endl;
+    if (static_cast<int>(_result.shards.size()) != _result.shard_count) {
+        std::cout << "Only shard(s)";
+        for (int shard : _result.shards) {
+            std::cout << " " << shard;
+        }
+        std::cout << " of " << _result.shard_count << " are included" << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < _result.sets.size(); i++) {
+        const SetResult &set_result = _result.sets.at(i);
+        uint64_t attacks = set_result.hits + set_result.crits + set_result.misses;
+        // Percentage of all attacks, guards against empty shards
+        auto percentage = [attacks](uint64_t count) {
+            return attacks == 0 ? 0.0 : 100.0 * static_cast<double>(count) / static_cast<double>(attacks);
+        };
+        std::cout << std::endl
+                  << "Attack set " << i + 1 << ": " << set_result.description << std::endl
+                  << "Hits: " << set_result.hits << " (" << percentage(set_result.hits) << "%), "
+                  << "Critical Hits: " << set_result.crits << " (" << percentage(set_result.crits) << "%), "
+                  << "Misses: " << set_result.misses << " (" << percentage(set_result.misses) << "%)" << std::endl;
+        for (const auto &[type, stats] : set_result.damage) {
+            uint64_t runs{};
+            for (const auto &[value, count] : stats.histogram) {
+                runs += count;
+            }
+            if (runs == 0) {
+                continue;
+            }
+            double mean = static_cast<double>(stats.sum) / static_cast<double>(runs);
+            double variance{};
+            int64_t median{};
+            uint64_t seen{};
+            for (const auto &[value, count] : stats.histogram) {
+                double deviation = static_cast<double>(value) - mean;
+                variance += static_cast<double>(count) * deviation * deviation;
+                if (seen < (runs + 1) / 2 && seen + count >= (runs + 1) / 2) {
+                    median = value;
+                }
+                seen += count;
+            }
+            variance /= static_cast<double>(runs);
+            std::cout << type << " Damage per trial: mean " << mean
+                      << ", std dev " << std::sqrt(variance)
+                      << ", min " << stats.histogram.begin()->first
+                      << ", median " << median
+                      << ", max " << stats.histogram.rbegin()->first << std::endl;
+        }
+    }
+    std::cout << std::defaultfloat;
+}
+
+SimResult Simulator::read(const std::string &file_name) {
+    std::ifstream file{ file_name };
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open file: " + file_name);
+    }
+    SimResult result{};
+    SetResult *set_result{ nullptr };
+    DamageStats *stats{ nullptr };
+    std::string buf{};
+    while (std::getline(file, buf)) {
+        if (buf.empty()) {
+            continue;
+        }
+        size_t idx = buf.find(':');
+        if (idx == std::string::npos) {
+            throw std::invalid_argument("Invalid line in partial result file: " + buf);
+        }
+        std::string key = buf.substr(0, idx);
+        std::string value = buf.substr(idx + 1);
+        try {
+            if (key == "partial") {
+                if (value != "5") {
+                    throw std::invalid_argument("Unsupported partial result file version: " + value);
+                }
+            }
+            else if (key == "seed") {
+                result.seed = std::stoull(value);
+            }
+            else if (key == "trials") {
+                result.trials = std::stoull(value);
+            }
+            else if (key == "mode") {
+                if (value != "totals" && value != "attacks") {
+                    throw std::invalid_argument("Invalid mode in partial result file: " + value);
+                }
+                result.totals_only = value == "totals";
+            }
+            else if (key == "shards") {
+                result.shard_count = std::stoi(value);
+            }
+            else if (key == "shard") {
+                std::istringstream shards{ value };
+                int shard{};
+                while (shards >> shard) {
+                    result.shards.push_back(shard);
+                }
+            }
+            else if (key == "runs") {
+                result.runs = std::stoull(value);
+            }
+            else if (key == "set") {
+                result.sets.push_back(SetResult{});
+                set_result = &result.sets.back();
+                set_result->description = value;
+                stats = nullptr;
+            }
+            else if (set_result == nullptr) {
+                throw std::invalid_argument("Attack set values before set in partial result file: " + buf);
+            }
+            else if (key == "hits") {
+                set_result->hits = std::stoull(value);
+            }
+            else if (key == "crits") {
+                set_result->crits = std::stoull(value);
+            }
+            else if (key == "misses") {
+                set_result->misses = std::stoull(value);
+            }
+            else if (key == "damage") {
+                stats = &set_result->damage[value];
+            }
+            else if (stats == nullptr) {
+                throw std::invalid_argument("Damage values before damage in partial result file: " + buf);
+            }
+            else if (key == "sum") {
+                stats->sum = std::stoll(value);
+            }
+            else if (key == "histogram") {
+                std::istringstream pairs{ value };
+                std::string pair{};
+                while (pairs >> pair) {
+                    size_t eq = pair.find('=');
+                    if (eq == std::string::npos) {
+                        throw std::invalid_argument("Invalid histogram entry in partial result file: " + pair);
+                    }
+                    stats->histogram[std::stoll(pair.substr(0, eq))] += std::stoull(pair.substr(eq + 1));
+                }
+            }
+            else {
+                throw std::invalid_argument("Invalid line in partial result file: " + buf);
+            }
+        }
+        catch (const std::out_of_range &) {
+            throw std::invalid_argument("Invalid value in partial result file: " + buf);
+        }
+    }
+    if (result.shard_count < 1 || result.shards.empty()) {
+        throw std::invalid_argument("File is not a partial result file: " + file_name);
+    }
+    // Every listed shard must exist and be listed once, and together they must contain exactly the runs in the file
+    std::vector<int> shards{ result.shards };
+    std::sort(shards.begin(), shards.end());
+    uint64_t runs{};
+    for (size_t i = 0; i < shards.size(); i++) {
+        if (shards.at(i) < 0 || shards.at(i) >= result.shard_count) {
+            throw std::invalid_argument("Shard " + std::to_string(shards.at(i)) + " in " + file_name + " is not one of the " + std::to_string(result.shard_count) + " shards.");
+        }
+        if (i > 0 && shards.at(i) == shards.at(i - 1)) {
+            throw std::invalid_argument("Shard " + std::to_string(shards.at(i)) + " is listed more than once in " + file_name + ".");
+        }
+        runs += shard_trials(result.trials, static_cast<uint64_t>(result.shard_count), static_cast<uint64_t>(shards.at(i)));
+    }
+    if (runs != result.runs) {
+        throw std::invalid_argument("Partial result file " + file_name + " has " + std::to_string(result.runs) + " runs, its shards contain " + std::to_string(runs) + ".");
+    }
+    return result;
+}
+
+std::string Simulator::describe(const RollVals &vals, bool with_ac) {
+    std::ostringstream description{};
+    description << vals.attack_count << " attacks, modifier " << vals.modifier << ", ";
+    if (with_ac) {
+        description << "AC " << vals.ac << ", ";
+    }
+    if (vals.attack_type == ADVANTAGE) {
+        description << "advantage";
+    }
+    else if (vals.attack_type == DISADVANTAGE) {
+        description << "disadvantage";
+    }
+    else {
+        description << "normal";
+    }
+    description << ", crit range " << vals.crit_range << ", damage ";
+    for (size_t i = 0; i < vals.damages.size(); i++) {
+        const Damage &damage = vals.damages.at(i);
+        description << (i == 0 ? "" : " + ") << dice_notation(damage);
+        if (damage.modifier != 0) {
+            description << std::showpos << damage.modifier << std::noshowpos;
+        }
+        description << " " << damage.type;
+    }
+    return description.str();
+}
\ No newline at end of file